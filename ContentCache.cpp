@@ -0,0 +1,100 @@
+#include "ContentCache.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+ContentCache::ContentCache(size_t budget_bytes) {
+   stats_.budget_bytes = budget_bytes;
+}
+
+ContentCache& ContentCache::instance() {
+   static ContentCache cache(256u << 20);
+   return cache;
+} // instance
+
+std::string ContentCache::load(const ContentSource& source) {
+   int fd = ::open(source.path.c_str(), O_RDONLY | O_CLOEXEC);
+   if (fd < 0) {
+      throw std::runtime_error("Cannot open " + source.path + ": " + std::strerror(errno));
+   }
+
+   std::string body(source.length, '\0');
+   size_t done = 0;
+   while (done < source.length) {
+      ssize_t n = ::pread(fd, &body[done], source.length - done, static_cast<off_t>(source.offset + done));
+      if (n < 0 && errno == EINTR) { continue; }
+      if (n <= 0) { break; }
+      done += static_cast<size_t>(n);
+   }
+   ::close(fd);
+
+   if (done != source.length) {
+      throw std::runtime_error("Short read of " + std::to_string(source.length) + " bytes at offset "
+                               + std::to_string(source.offset) + " in " + source.path);
+   }
+   return body;
+} // load
+
+std::shared_ptr<const std::string> ContentCache::get(const ContentSource& source) {
+   std::string key = source.path + '\0' + std::to_string(source.offset) + ':' + std::to_string(source.length);
+
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto found = entries_.find(key);
+      if (found != entries_.end()) {
+         ++stats_.hits;
+         lru_.splice(lru_.begin(), lru_, found->second);
+         return found->second->data;
+      }
+      ++stats_.misses;
+   }
+
+   // load without holding the lock, so other threads' hits aren't stuck behind the disk
+   auto data = std::make_shared<const std::string>(load(source));
+
+   std::lock_guard<std::mutex> lock(mutex_);
+   auto found = entries_.find(key);
+   if (found != entries_.end()) { return found->second->data; } // another thread loaded it meanwhile
+
+   lru_.push_front({key, data});
+   entries_[key] = lru_.begin();
+   stats_.resident_bytes += data->size();
+   evictOverBudget();
+   return data;
+} // get
+
+void ContentCache::evictOverBudget() {
+   while (stats_.resident_bytes > stats_.budget_bytes && !lru_.empty()) {
+      Entry& victim = lru_.back();
+      stats_.resident_bytes -= victim.data->size();
+      entries_.erase(victim.key);
+      lru_.pop_back();
+      ++stats_.evictions;
+   }
+} // evictOverBudget
+
+void ContentCache::setBudget(size_t budget_bytes) {
+   std::lock_guard<std::mutex> lock(mutex_);
+   stats_.budget_bytes = budget_bytes;
+   evictOverBudget();
+} // setBudget
+
+CacheStats ContentCache::getStats() const {
+   std::lock_guard<std::mutex> lock(mutex_);
+   return stats_;
+} // getStats
+
+void ContentCache::resetStats() {
+   std::lock_guard<std::mutex> lock(mutex_);
+   stats_.hits = 0;
+   stats_.misses = 0;
+   stats_.evictions = 0;
+} // resetStats
+
+void ContentCache::clear() {
+   std::lock_guard<std::mutex> lock(mutex_);
+   lru_.clear();
+   entries_.clear();
+   stats_.resident_bytes = 0;
+} // clear
@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <stdexcept>
+
+/**
+ * @brief Where the contents of a lazily loaded File live: length bytes at offset within a local data file
+ */
+struct ContentSource {
+   std::string path;
+   size_t offset = 0;
+   size_t length = 0;
+};
+
+/**
+ * @brief Counters describing the ContentCache since it was created or last reset
+ */
+struct CacheStats {
+   size_t hits = 0;
+   size_t misses = 0;
+   size_t evictions = 0;
+   size_t resident_bytes = 0;
+   size_t budget_bytes = 0;
+};
+
+/**
+ * @brief A process-wide LRU cache of lazily loaded File contents, bounded by a memory budget.
+ *
+ * Entries are keyed by (path, offset, length), so copies of a File share one cached body.
+ * When loading a body pushes the resident total over budget, the least recently used bodies are evicted.
+ * get() hands out shared pointers, so an evicted body stays valid for callers still holding it;
+ *    it just no longer counts against the budget.
+ */
+class ContentCache {
+   private:
+      struct Entry {
+         std::string key;
+         std::shared_ptr<const std::string> data;
+      };
+
+      mutable std::mutex mutex_;
+      std::list<Entry> lru_; // most recently used first
+      std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+      CacheStats stats_;
+
+      ContentCache(size_t budget_bytes);
+
+      /**
+       * @brief Drops least recently used entries until the resident total fits the budget. Caller holds mutex_.
+       */
+      void evictOverBudget();
+
+      /**
+       * @brief Reads a source's bytes from disk with pread()
+       * @throws std::runtime_error If the data file cannot be read in full
+       */
+      static std::string load(const ContentSource& source);
+
+   public:
+      /**
+       * @brief Get the process-wide cache (256 MiB budget until setBudget() is called)
+       */
+      static ContentCache& instance();
+
+      ContentCache(const ContentCache&) = delete;
+      ContentCache& operator=(const ContentCache&) = delete;
+
+      /**
+       * @brief Returns the contents described by source, loading them from disk on a miss
+       * @throws std::runtime_error If the contents have to be loaded and cannot be
+       */
+      std::shared_ptr<const std::string> get(const ContentSource& source);
+
+      /**
+       * @brief Changes the memory budget, evicting immediately if the cache is now over it
+       */
+      void setBudget(size_t budget_bytes);
+
+      /**
+       * @brief Get a copy of the counters
+       */
+      CacheStats getStats() const;
+
+      /**
+       * @brief Zeroes the hit, miss and eviction counters
+       */
+      void resetStats();
+
+      /**
+       * @brief Evicts every entry (without counting them as evictions)
+       */
+      void clear();
+};
@@ -0,0 +1,213 @@
+#include "ContentIndex.hpp"
+#include <algorithm>
+
+uint32_t ContentIndex::gramAt(const std::string& text, size_t pos) {
+   return (static_cast<uint32_t>(static_cast<unsigned char>(text[pos])) << 16)
+        | (static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 1])) << 8)
+        |  static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 2]));
+} // gramAt
+
+void ContentIndex::Postings::append(uint32_t id) {
+   uint32_t gap = id - last; // the first id is stored as its gap from 0
+   while (gap >= 0x80) {
+      bytes.push_back(static_cast<uint8_t>(gap | 0x80));
+      gap >>= 7;
+   }
+   bytes.push_back(static_cast<uint8_t>(gap));
+   last = id;
+   ++count;
+} // Postings::append
+
+uint32_t ContentIndex::Postings::gapAt(size_t& pos) const {
+   uint32_t gap = 0;
+   for (int shift = 0; ; shift += 7) {
+      uint8_t byte = bytes[pos++];
+      gap |= static_cast<uint32_t>(byte & 0x7F) << shift;
+      if (byte < 0x80) { return gap; }
+   }
+} // Postings::gapAt
+
+std::vector<uint32_t> ContentIndex::Postings::decode() const {
+   std::vector<uint32_t> ids;
+   ids.reserve(count);
+
+   uint32_t id = 0;
+   for (size_t i = 0; i < bytes.size(); ) {
+      id += gapAt(i);
+      ids.push_back(id);
+   }
+   return ids;
+} // Postings::decode
+
+const ContentIndex::Postings* ContentIndex::postingsOf(uint32_t gram) const {
+   if (page_of_.empty()) { return nullptr; }
+
+   uint32_t slot = slots_[page_of_[gram >> 8] * PAGE + (gram & 0xFF)];
+   return slot == 0 ? nullptr : &postings_[slot];
+} // postingsOf
+
+ContentIndex::Postings& ContentIndex::postingsFor(uint32_t gram) {
+   if (page_of_.empty()) {
+      page_of_.assign(1u << 16, 0);
+      slots_.assign(PAGE, 0); // page 0
+      postings_.resize(1);
+   }
+
+   uint32_t& page = page_of_[gram >> 8];
+   if (page == 0) {
+      page = static_cast<uint32_t>(slots_.size() / PAGE);
+      slots_.resize(slots_.size() + PAGE, 0);
+   }
+
+   uint32_t& slot = slots_[page * PAGE + (gram & 0xFF)];
+   if (slot == 0) {
+      slot = static_cast<uint32_t>(postings_.size());
+      postings_.emplace_back();
+   }
+   return postings_[slot];
+} // postingsFor
+
+std::vector<uint32_t> ContentIndex::trigramsOf(const std::string& text) {
+   std::vector<uint32_t> grams;
+   if (text.size() < GRAM) { return grams; }
+
+   grams.reserve(text.size() - GRAM + 1);
+   for (size_t i = 0; i + GRAM <= text.size(); ++i) {
+      grams.push_back(gramAt(text, i));
+   }
+
+   std::sort(grams.begin(), grams.end());
+   grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+   return grams;
+} // trigramsOf
+
+void ContentIndex::add(const std::string& name, const std::string& contents) {
+   remove(name);
+
+   uint32_t id = static_cast<uint32_t>(names_.size());
+   names_.push_back(name);
+   ids_[name] = id;
+
+   // ids only ever grow, so push_back keeps each posting list sorted,
+   //    and a repeated trigram within this file always finds its own id at the back
+   for (size_t i = 0; i + GRAM <= contents.size(); ++i) {
+      Postings& list = postingsFor(gramAt(contents, i));
+      if (list.count == 0 || list.last != id) { list.append(id); }
+   }
+} // add
+
+void ContentIndex::add(const File& file) {
+   std::string name = file.getName();
+   file.visitContents([&](const std::string& contents) { add(name, contents); });
+} // add (File)
+
+bool ContentIndex::remove(const std::string& name) {
+   auto found = ids_.find(name);
+   if (found == ids_.end()) { return false; }
+
+   names_[found->second].clear();
+   ids_.erase(found);
+   ++dead_;
+
+   if (dead_ >= MIN_PURGE && dead_ > ids_.size()) { purge(); }
+   return true;
+} // remove
+
+void ContentIndex::purge() {
+   const uint32_t DEAD = UINT32_MAX;
+
+   // old id -> new id, preserving order so posting lists stay sorted
+   std::vector<uint32_t> remap(names_.size(), DEAD);
+   std::vector<std::string> live_names;
+   live_names.reserve(ids_.size());
+
+   for (size_t old_id = 0; old_id < names_.size(); ++old_id) {
+      if (names_[old_id].empty()) { continue; }
+      remap[old_id] = static_cast<uint32_t>(live_names.size());
+      ids_[names_[old_id]] = remap[old_id];
+      live_names.push_back(std::move(names_[old_id]));
+   }
+
+   for (Postings& list : postings_) {
+      Postings kept;
+      for (uint32_t id : list.decode()) {
+         if (remap[id] != DEAD) { kept.append(remap[id]); }
+      }
+      kept.bytes.shrink_to_fit();
+      list = std::move(kept);
+   }
+
+   names_ = std::move(live_names);
+   dead_ = 0;
+} // purge
+
+std::vector<std::string> ContentIndex::candidates(const std::string& text) const {
+   std::vector<std::string> result;
+   std::vector<uint32_t> grams = trigramsOf(text);
+
+   if (grams.empty()) {
+      result.reserve(ids_.size());
+      for (const auto& entry : ids_) { result.push_back(entry.first); }
+      std::sort(result.begin(), result.end());
+      return result;
+   }
+
+   // intersect the posting lists, shortest first so the running set shrinks fastest
+   std::vector<const Postings*> lists;
+   for (uint32_t gram : grams) {
+      const Postings* list = postingsOf(gram);
+      if (list == nullptr || list->count == 0) { return result; }
+      lists.push_back(list);
+   }
+   std::sort(lists.begin(), lists.end(), [](const Postings* a, const Postings* b) { return a->count < b->count; });
+
+   std::vector<uint32_t> matched = lists[0]->decode();
+   for (size_t l = 1; l < lists.size() && !matched.empty(); ++l) {
+      intersect(matched, *lists[l]);
+   }
+
+   for (uint32_t id : matched) {
+      if (!names_[id].empty()) { result.push_back(names_[id]); }
+   }
+   std::sort(result.begin(), result.end());
+   return result;
+} // candidates
+
+void ContentIndex::intersect(std::vector<uint32_t>& matched, const Postings& list) {
+   size_t kept = 0;
+   size_t m = 0;
+   uint32_t id = 0;
+   for (size_t i = 0; i < list.bytes.size() && m < matched.size(); ) {
+      id += list.gapAt(i);
+
+      while (m < matched.size() && matched[m] < id) { ++m; }
+      if (m < matched.size() && matched[m] == id) { matched[kept++] = matched[m++]; }
+   }
+   matched.resize(kept);
+} // intersect
+
+void ContentIndex::clear() {
+   page_of_.clear();
+   slots_.clear();
+   postings_.clear();
+   ids_.clear();
+   names_.clear();
+   dead_ = 0;
+} // clear
+
+size_t ContentIndex::size() const {
+   return ids_.size();
+} // size
+
+size_t ContentIndex::getMemoryBytes() const {
+   size_t bytes = page_of_.capacity() * sizeof(uint32_t) + slots_.capacity() * sizeof(uint32_t)
+                + postings_.capacity() * sizeof(Postings) + names_.capacity() * sizeof(std::string);
+   for (const Postings& list : postings_) { bytes += list.bytes.capacity(); }
+   for (const std::string& name : names_) { bytes += name.capacity() > 15 ? name.capacity() + 1 : 0; } // past SSO
+   bytes += ids_.size() * (sizeof(std::string) + sizeof(uint32_t) + 2 * sizeof(void*)); // hash nodes, roughly
+   return bytes;
+} // getMemoryBytes
+
+void ContentIndex::shrinkToFit() {
+   for (Postings& list : postings_) { list.bytes.shrink_to_fit(); }
+} // shrinkToFit
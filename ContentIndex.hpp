@@ -0,0 +1,142 @@
+#pragma once
+#include "File.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+/**
+ * @brief An incrementally maintained trigram index over the contents of a set of named files.
+ *
+ * Every distinct 3-byte sequence in a file's contents maps to a posting list of document ids.
+ * Trigrams are resolved to posting lists through a two-level table (high 16 bits pick a page of 256 slots)
+ *    rather than a hash map, so indexing costs two array loads per byte of content and no sorting.
+ * Document ids are handed out in increasing order, so appending to a posting list keeps it sorted and
+ *    queries can intersect lists with a linear merge. Each list is stored as varint-encoded gaps between
+ *    successive ids; common trigrams appear in most documents, so most gaps fit in one byte instead of four.
+ * Removed documents are tombstoned and purged from the posting lists in bulk once they outnumber the live ones.
+ *
+ * The index only narrows the search: candidates() returns a superset of the files containing the text,
+ *    and the caller verifies each candidate against the real contents.
+ */
+class ContentIndex {
+   public:
+      static const size_t GRAM = 3; // texts shorter than this cannot be narrowed by the index
+
+   private:
+      static const size_t MIN_PURGE = 1024; // don't bother compacting tiny indexes
+
+      static const size_t PAGE = 256; // slots per page, one per value of a trigram's last byte
+
+      /**
+       * @brief A sorted posting list of document ids, stored as the varint-encoded gaps between them
+       */
+      struct Postings {
+         std::vector<uint8_t> bytes;
+         uint32_t last = 0;  // the most recently appended id
+         uint32_t count = 0;
+
+         /**
+          * @brief Appends an id, which must be greater than last unless the list is empty
+          */
+         void append(uint32_t id);
+
+         /**
+          * @brief Decodes the gap starting at bytes[pos], advancing pos past it
+          */
+         uint32_t gapAt(size_t& pos) const;
+
+         /**
+          * @brief Decodes the list into plain ids
+          */
+         std::vector<uint32_t> decode() const;
+      };
+
+      std::vector<uint32_t> page_of_;  // trigram >> 8 -> page number; 0 is an all-empty page. Sized on first add.
+      std::vector<uint32_t> slots_;    // page * PAGE + (trigram & 0xFF) -> index into postings_, 0 if none
+      std::vector<Postings> postings_; // posting lists; postings_[0] stays empty
+      std::unordered_map<std::string, uint32_t> ids_; // live name -> document id
+      std::vector<std::string> names_;                // document id -> name, "" once removed
+      size_t dead_ = 0;
+
+      /**
+       * @brief Packs the 3 bytes of text starting at pos into one key
+       */
+      static uint32_t gramAt(const std::string& text, size_t pos);
+
+      /**
+       * @brief Returns the posting list of a trigram, or nullptr if it has none
+       */
+      const Postings* postingsOf(uint32_t gram) const;
+
+      /**
+       * @brief Returns the posting list of a trigram, creating an empty one (and its page) if needed
+       */
+      Postings& postingsFor(uint32_t gram);
+
+      /**
+       * @brief Keeps only the ids of matched (sorted) that also appear in list, decoding list as it goes
+       */
+      static void intersect(std::vector<uint32_t>& matched, const Postings& list);
+
+      /**
+       * @brief Returns the distinct trigrams of text, sorted
+       */
+      static std::vector<uint32_t> trigramsOf(const std::string& text);
+
+      /**
+       * @brief Drops tombstoned ids from every posting list and renumbers the live documents
+       */
+      void purge();
+
+   public:
+      /**
+       * @brief Indexes the contents of a file. If the name is already indexed, its old entry is replaced.
+       *
+       * @param name A const reference to the filename
+       * @param contents A const reference to the file's contents
+       */
+      void add(const std::string& name, const std::string& contents);
+
+      /**
+       * @brief Indexes a File under its name, reading its contents by const reference (no copy)
+       *
+       * @param file A const reference to the File
+       */
+      void add(const File& file);
+
+      /**
+       * @brief Removes a file from the index
+       * @return True if the name was indexed. False otherwise.
+       */
+      bool remove(const std::string& name);
+
+      /**
+       * @brief Lists the files which may contain the given text
+       * Texts shorter than a trigram cannot be looked up, so every indexed file is returned for them.
+       *
+       * @param text A const reference to the text being searched for
+       * @return std::vector<std::string> Candidate filenames, in sorted order
+       */
+      std::vector<std::string> candidates(const std::string& text) const;
+
+      /**
+       * @brief Empties the index
+       */
+      void clear();
+
+      /**
+       * @brief Get the number of indexed files
+       */
+      size_t size() const;
+
+      /**
+       * @brief Get the approximate heap memory held by the index, in bytes
+       */
+      size_t getMemoryBytes() const;
+
+      /**
+       * @brief Releases the spare capacity of every posting list, eg. after a bulk build
+       */
+      void shrinkToFit();
+};
@@ -5,10 +5,12 @@ std::string File::getName() const {
 }
 
 std::string File::getContents() const {
+   if (source_) { return *ContentCache::instance().get(*source_); }
    return contents_;
 }
 
 void File::setContents(const std::string& new_contents) {
+   source_.reset();
    contents_ = new_contents;
 }
 
@@ -43,7 +45,7 @@ bool File::operator<(const File& rhs) const {
 
 // =========================== YOUR CODE HERE ===========================
 
-File::File(const std::string& filename, const std::string& contents, int* icon) : contents_(contents), icon_(icon) {
+File::File(const std::string& filename, std::string contents, int* icon) : contents_(std::move(contents)), icon_(icon) {
    // if not empty filename, validate file name
    if (filename.length() > 0) {
       bool extension_exist = false;
@@ -74,13 +76,64 @@ File::File(const std::string& filename, const std::string& contents, int* icon)
    }
 } // Constructor
 
+File::File(const std::string& filename, const ContentSource& source, int* icon) : File(filename, "", icon) {
+   source_ = std::make_shared<const ContentSource>(source);
+} // Lazy Constructor
+
+bool File::isLazy() const {
+   return source_ != nullptr;
+} // isLazy
+
+std::string File::getContents(size_t pos, size_t count) const {
+   if (source_) {
+      std::shared_ptr<const std::string> loaded = ContentCache::instance().get(*source_);
+      return pos < loaded->size() ? loaded->substr(pos, count) : "";
+   }
+   return pos < contents_.size() ? contents_.substr(pos, count) : "";
+} // getContents (range)
+
 size_t File::getSize() const {
    // every char within the string = 1 byte
+   if (source_) { return source_->length; }
    return contents_.size();
 } // getSize
 
+void File::visitContents(const std::function<void(const std::string&)>& visit) const {
+   if (!source_) {
+      visit(contents_);
+      return;
+   }
+
+   // keep the cached body alive while it is visited, even if it gets evicted meanwhile
+   std::shared_ptr<const std::string> loaded = ContentCache::instance().get(*source_);
+   visit(*loaded);
+} // visitContents
+
+bool File::contains(const std::string& text, bool whole_word) const {
+   bool found = false;
+
+   visitContents([&](const std::string& body) {
+      for (size_t pos = body.find(text); pos != std::string::npos; pos = body.find(text, pos + 1)) {
+         if (!whole_word) {
+            found = true;
+            return;
+         }
+
+         size_t end = pos + text.size();
+         bool starts_word = (pos == 0) || !isalnum(static_cast<unsigned char>(body[pos - 1]));
+         bool ends_word = (end == body.size()) || !isalnum(static_cast<unsigned char>(body[end]));
+         if (starts_word && ends_word) {
+            found = true;
+            return;
+         }
+      }
+   });
+
+   return found;
+} // contains
+
 
-File::File(const File& rhs) : filename_(rhs.filename_), contents_(rhs.contents_) {
+File::File(const File& rhs) : filename_(rhs.filename_), contents_(rhs.contents_), source_(rhs.source_) {
    if (rhs.icon_ != nullptr) {
       //deep copy rhs.icon_ to this->icon_ if rhs has an icon 
       this->icon_ = new int [ICON_DIM];
@@ -97,6 +150,7 @@ File& File::operator=(const File& rhs) {
       //deep copy rhs datamembers to this->datamembers
       this->filename_ = rhs.filename_;
       this->contents_ = rhs.contents_;
+      this->source_ = rhs.source_;
       if (rhs.icon_ != nullptr) {
          this->icon_ = new int [ICON_DIM];
          std::copy(rhs.icon_, rhs.icon_ + ICON_DIM, this->icon_);
@@ -107,7 +161,7 @@ File& File::operator=(const File& rhs) {
    return *this;
 } // Copy Assignment
 
-File::File(File&& rhs) : filename_(std::move(rhs.filename_)), contents_(std::move(rhs.contents_)), icon_(rhs.icon_) {
+File::File(File&& rhs) : filename_(std::move(rhs.filename_)), contents_(std::move(rhs.contents_)), icon_(rhs.icon_), source_(std::move(rhs.source_)) {
    rhs.icon_ = nullptr;
 } // Move Constructor
 
@@ -118,6 +172,7 @@ File& File::operator=(File&& rhs) {
       this->filename_ = std::move(rhs.filename_);
       this->contents_ = std::move(rhs.contents_);
       this->icon_ = rhs.icon_;
+      this->source_ = std::move(rhs.source_);
 
       rhs.icon_ = nullptr;
    }
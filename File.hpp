@@ -3,12 +3,16 @@
 #include <iostream>
 #include <algorithm>
 #include "InvalidFormatException.hpp"
+#include "ContentCache.hpp"
+#include <memory>
+#include <functional>
 
 class File {
    private:
       std::string filename_;
       std::string contents_;
       int* icon_;
+      std::shared_ptr<const ContentSource> source_; // set only while contents are lazily loaded
 
       static const size_t ICON_DIM = 256; // Representing a 16 x 16 bitmap
 
@@ -65,20 +69,64 @@ class File {
       *    - If no extension is provided (e.g. there is no period within the provided filename) or nothing follows the period, then ".txt" is used as the extension
       *    - Default value of "NewFile.txt" if none provided or if filename is empty 
       * @param contents A string representing the contents of the file. Default to empty string if none provided.
+      *    - Taken by value and moved into place, so callers handing over an r-value (eg. a freshly read file body) avoid a copy
       * @param icon A pointer to an integer array with length ICON_DIM. Default to nullptr if none provided.
       * @throws InvalidFormatException - An error that occurs if the filename is not valid by the above constraints.
       * @note You'll notice we provide a default value for the first possible argument (filename)
       *       Yes, this means we can define override the default constructor and define a parameterized one simultaneously.
       */
-      File(const std::string& filename = "NewFile.txt", const std::string& contents = "", int* icon = nullptr);
+      File(const std::string& filename = "NewFile.txt", std::string contents = "", int* icon = nullptr);
+
+      /**
+      * @brief Constructs a new File object whose contents are loaded lazily from a local data file.
+      * Nothing is read here: the contents are materialized through ContentCache on the first getContents(), 
+      *    range read or contains(), and may be evicted and reloaded later. getName() and getSize() never load them.
+      * 
+      * @param filename A const reference to a filename, validated exactly as by the constructor above
+      * @param source A const reference to the location of the contents (path, offset and length)
+      * @param icon A pointer to an integer array with length ICON_DIM. Default to nullptr if none provided.
+      * @throws InvalidFormatException - If the filename is not valid
+      */
+      File(const std::string& filename, const ContentSource& source, int* icon = nullptr);
+
+      /**
+      * @brief Returns true if the File's contents are backed by a ContentSource rather than held in memory
+      * @note setContents() makes a lazy File resident again
+      */
+      bool isLazy() const;
+
+      /**
+      * @brief Get up to count bytes of the contents, starting at pos
+      * @return std::string The requested range, clipped to the end of the contents. Empty if pos is past the end.
+      */
+      std::string getContents(size_t pos, size_t count) const;
 
       /**
       * @brief Calculates and returns the size of the File Object (IN BYTES), using .size()
+      *    For a lazy File this is the length of its ContentSource, so nothing is loaded.
       * @return size_t The number of bytes the File's contents consumes
       * @note Consider this: how does this relate to the string's length? Why is that the case?
       */
       size_t getSize() const;
 
+      /**
+      * @brief Calls visit with a const reference to the File's contents, without copying them
+      *    A lazy File's contents are materialized through ContentCache and kept alive until visit returns.
+      * 
+      * @param visit A callable taking the contents as a const std::string&
+      */
+      void visitContents(const std::function<void(const std::string&)>& visit) const;
+
+      /**
+      * @brief Searches the File's contents for the given text without copying them
+      * 
+      * @param text A const reference to the text to search for. Empty text is always found.
+      *    A lazy File's contents are materialized through ContentCache.
+      * @param whole_word If true, a match only counts when it is not directly preceded or followed by an alphanumeric character
+      * @return True if the text occurs in the contents. False otherwise.
+      */
+      bool contains(const std::string& text, bool whole_word = false) const;
+
       /**
        * @brief (COPY CONSTRUCTOR) Constructs a new File object as a deep copy of the target File
        * @param rhs A const reference to the file to be copied from
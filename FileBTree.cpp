@@ -0,0 +1,244 @@
+#include "FileBTree.hpp"
+
+FileBTree::FileBTree(const FileBTree& rhs) : size_(rhs.size_) {
+   if (rhs.root_) {
+      Node* last_leaf = nullptr;
+      root_ = clone(rhs.root_.get(), last_leaf);
+   }
+} // Copy Constructor
+
+FileBTree& FileBTree::operator=(const FileBTree& rhs) {
+   if (this != &rhs) {
+      FileBTree copy(rhs);
+      *this = std::move(copy);
+   }
+   return *this;
+} // Copy Assignment
+
+FileBTree::FileBTree(FileBTree&& rhs) noexcept : root_(std::move(rhs.root_)), size_(rhs.size_) {
+   rhs.size_ = 0;
+} // Move Constructor
+
+FileBTree& FileBTree::operator=(FileBTree&& rhs) noexcept {
+   if (this != &rhs) {
+      root_ = std::move(rhs.root_);
+      size_ = rhs.size_;
+      rhs.size_ = 0;
+   }
+   return *this;
+} // Move Assignment
+
+std::unique_ptr<FileBTree::Node> FileBTree::clone(const Node* node, Node*& last_leaf) {
+   auto copy = std::make_unique<Node>(node->leaf);
+
+   if (node->leaf) {
+      copy->files = node->files;
+      if (last_leaf != nullptr) { last_leaf->next = copy.get(); }
+      last_leaf = copy.get();
+   } else {
+      // children are cloned left to right, so leaves get chained in order
+      copy->keys = node->keys;
+      for (const auto& child : node->children) {
+         copy->children.push_back(clone(child.get(), last_leaf));
+      }
+   }
+
+   return copy;
+} // clone
+
+size_t FileBTree::size() const {
+   return size_;
+} // size
+
+size_t FileBTree::childIndex(const Node* node, const std::string& name) {
+   return std::upper_bound(node->keys.begin(), node->keys.end(), name) - node->keys.begin();
+} // childIndex
+
+size_t FileBTree::leafIndex(const Node* leaf, const std::string& name) {
+   auto it = std::lower_bound(leaf->files.begin(), leaf->files.end(), name,
+      [](const File& file, const std::string& target) { return file.getName() < target; });
+   return it - leaf->files.begin();
+} // leafIndex
+
+FileBTree::Node* FileBTree::findLeaf(const std::string& name) const {
+   Node* node = root_.get();
+   while (!node->leaf) {
+      node = node->children[childIndex(node, name)].get();
+   }
+   return node;
+} // findLeaf
+
+File* FileBTree::find(const std::string& name) {
+   if (!root_) { return nullptr; }
+
+   Node* leaf = findLeaf(name);
+   size_t i = leafIndex(leaf, name);
+   if (i == leaf->files.size() || leaf->files[i].getName() != name) { return nullptr; }
+   return &leaf->files[i];
+} // find
+
+const File* FileBTree::find(const std::string& name) const {
+   return const_cast<FileBTree*>(this)->find(name);
+} // find (const)
+
+File* FileBTree::insert(File&& file) {
+   if (!root_) {
+      root_ = std::make_unique<Node>(true);
+      root_->files.reserve(LEAF_CAPACITY + 1);
+   }
+
+   InsertResult result = insertInto(root_.get(), std::move(file));
+
+   if (result.split) {
+      // the root split -> grow the tree by one level
+      auto new_root = std::make_unique<Node>(false);
+      new_root->keys.push_back(std::move(result.separator));
+      new_root->children.push_back(std::move(root_));
+      new_root->children.push_back(std::move(result.split));
+      root_ = std::move(new_root);
+   }
+
+   if (result.inserted != nullptr) { ++size_; }
+   return result.inserted;
+} // insert
+
+FileBTree::InsertResult FileBTree::insertInto(Node* node, File&& file) {
+   InsertResult result;
+   std::string name = file.getName();
+
+   if (node->leaf) {
+      size_t i = leafIndex(node, name);
+      if (i < node->files.size() && node->files[i].getName() == name) { return result; } // duplicate
+
+      node->files.insert(node->files.begin() + i, std::move(file));
+      if (node->files.size() <= LEAF_CAPACITY) {
+         result.inserted = &node->files[i];
+         return result;
+      }
+
+      // overfull -> move the upper half into a new right sibling
+      size_t mid = node->files.size() / 2;
+      auto right = std::make_unique<Node>(true);
+      right->files.reserve(LEAF_CAPACITY + 1);
+      std::move(node->files.begin() + mid, node->files.end(), std::back_inserter(right->files));
+      node->files.erase(node->files.begin() + mid, node->files.end());
+      right->next = node->next;
+      node->next = right.get();
+
+      result.inserted = (i < mid) ? &node->files[i] : &right->files[i - mid];
+      result.separator = right->files.front().getName();
+      result.split = std::move(right);
+      return result;
+   }
+
+   size_t c = childIndex(node, name);
+   InsertResult below = insertInto(node->children[c].get(), std::move(file));
+   result.inserted = below.inserted;
+   if (!below.split) { return result; }
+
+   node->keys.insert(node->keys.begin() + c, std::move(below.separator));
+   node->children.insert(node->children.begin() + c + 1, std::move(below.split));
+   if (node->children.size() <= INNER_CAPACITY) { return result; }
+
+   // overfull -> the middle key moves up, everything right of it goes to a new sibling
+   size_t mid = node->keys.size() / 2;
+   auto right = std::make_unique<Node>(false);
+   result.separator = std::move(node->keys[mid]);
+   std::move(node->keys.begin() + mid + 1, node->keys.end(), std::back_inserter(right->keys));
+   std::move(node->children.begin() + mid + 1, node->children.end(), std::back_inserter(right->children));
+   node->keys.resize(mid);
+   node->children.resize(mid + 1);
+   result.split = std::move(right);
+   return result;
+} // insertInto
+
+bool FileBTree::erase(const std::string& name, File* out) {
+   if (!root_ || !eraseFrom(root_.get(), name, out)) { return false; }
+   --size_;
+
+   // shrink the tree when the root is down to a single child
+   if (!root_->leaf && root_->children.size() == 1) {
+      std::unique_ptr<Node> only = std::move(root_->children.front());
+      root_ = std::move(only);
+   }
+   if (size_ == 0) { root_.reset(); }
+   return true;
+} // erase
+
+bool FileBTree::eraseFrom(Node* node, const std::string& name, File* out) {
+   if (node->leaf) {
+      size_t i = leafIndex(node, name);
+      if (i == node->files.size() || node->files[i].getName() != name) { return false; }
+
+      if (out != nullptr) { *out = std::move(node->files[i]); }
+      node->files.erase(node->files.begin() + i);
+      return true;
+   }
+
+   size_t c = childIndex(node, name);
+   if (!eraseFrom(node->children[c].get(), name, out)) { return false; }
+
+   const Node* child = node->children[c].get();
+   size_t fill = child->leaf ? child->files.size() : child->children.size();
+   size_t minimum = (child->leaf ? LEAF_CAPACITY : INNER_CAPACITY) / 4;
+   if (fill < minimum) { rebalance(node, c); }
+   return true;
+} // eraseFrom
+
+void FileBTree::rebalance(Node* parent, size_t index) {
+   // pair the child with its left sibling if it has one, otherwise its right
+   size_t k = (index > 0) ? index - 1 : index; // keys[k] separates left and right
+   if (k + 1 >= parent->children.size()) { return; } // no sibling at all
+   Node* left = parent->children[k].get();
+   Node* right = parent->children[k + 1].get();
+
+   if (left->leaf) {
+      if (left->files.size() + right->files.size() <= LEAF_CAPACITY) {
+         // merge right into left
+         std::move(right->files.begin(), right->files.end(), std::back_inserter(left->files));
+         left->next = right->next;
+         parent->keys.erase(parent->keys.begin() + k);
+         parent->children.erase(parent->children.begin() + k + 1);
+         return;
+      }
+
+      // redistribute evenly across the pair
+      std::vector<File> all;
+      all.reserve(LEAF_CAPACITY + 1);
+      std::move(left->files.begin(), left->files.end(), std::back_inserter(all));
+      std::move(right->files.begin(), right->files.end(), std::back_inserter(all));
+      size_t half = all.size() / 2;
+      left->files.clear();
+      right->files.clear();
+      std::move(all.begin(), all.begin() + half, std::back_inserter(left->files));
+      std::move(all.begin() + half, all.end(), std::back_inserter(right->files));
+      parent->keys[k] = right->files.front().getName();
+      return;
+   }
+
+   if (left->children.size() + right->children.size() <= INNER_CAPACITY) {
+      // merge right into left, pulling the separator down between them
+      left->keys.push_back(std::move(parent->keys[k]));
+      std::move(right->keys.begin(), right->keys.end(), std::back_inserter(left->keys));
+      std::move(right->children.begin(), right->children.end(), std::back_inserter(left->children));
+      parent->keys.erase(parent->keys.begin() + k);
+      parent->children.erase(parent->children.begin() + k + 1);
+      return;
+   }
+
+   // redistribute: line up keys (with the separator between the halves) and children, then split them evenly
+   std::vector<std::string> keys;
+   std::vector<std::unique_ptr<Node>> children;
+   std::move(left->keys.begin(), left->keys.end(), std::back_inserter(keys));
+   keys.push_back(std::move(parent->keys[k]));
+   std::move(right->keys.begin(), right->keys.end(), std::back_inserter(keys));
+   std::move(left->children.begin(), left->children.end(), std::back_inserter(children));
+   std::move(right->children.begin(), right->children.end(), std::back_inserter(children));
+
+   size_t left_children = children.size() / 2;
+   left->keys.assign(std::make_move_iterator(keys.begin()), std::make_move_iterator(keys.begin() + left_children - 1));
+   parent->keys[k] = std::move(keys[left_children - 1]);
+   right->keys.assign(std::make_move_iterator(keys.begin() + left_children), std::make_move_iterator(keys.end()));
+   left->children.assign(std::make_move_iterator(children.begin()), std::make_move_iterator(children.begin() + left_children));
+   right->children.assign(std::make_move_iterator(children.begin() + left_children), std::make_move_iterator(children.end()));
+} // rebalance
@@ -0,0 +1,139 @@
+#pragma once
+#include "File.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+
+/**
+ * @brief A B+ tree of Files ordered by name.
+ *
+ * Files live only in the leaves, LEAF_CAPACITY to a node in one contiguous vector, and the leaves are chained
+ *    left to right so in-order iteration walks memory a leaf at a time. Inner nodes hold separator names:
+ *    every name under children[i] is less than keys[i], and every name under children[i + 1] is not.
+ *
+ * Insert and erase cost O(log N) node visits plus a shift of at most one node's worth of elements,
+ *    instead of the O(N) shift of a sorted vector. Nodes that fall below a quarter full after an erase
+ *    borrow from or merge with a sibling, so the tree stays balanced.
+ */
+class FileBTree {
+   private:
+      static const size_t LEAF_CAPACITY = 32;
+      static const size_t INNER_CAPACITY = 64;
+
+      struct Node {
+         bool leaf;
+         std::vector<std::string> keys;               // inner nodes: separators, one fewer than children
+         std::vector<std::unique_ptr<Node>> children; // inner nodes
+         std::vector<File> files;                     // leaves: sorted by name
+         Node* next = nullptr;                        // leaves: the leaf to the right
+
+         explicit Node(bool is_leaf) : leaf(is_leaf) {}
+      };
+
+      /**
+       * @brief Result of inserting below a node: the inserted File, plus the new right sibling if the node split
+       */
+      struct InsertResult {
+         File* inserted = nullptr;
+         std::unique_ptr<Node> split;
+         std::string separator;
+      };
+
+      std::unique_ptr<Node> root_; // nullptr when empty
+      size_t size_ = 0;
+
+      /**
+       * @brief Descends to the leaf that does (or would) hold name
+       */
+      Node* findLeaf(const std::string& name) const;
+
+      /**
+       * @brief Index of the child of an inner node whose subtree covers name
+       */
+      static size_t childIndex(const Node* node, const std::string& name);
+
+      /**
+       * @brief Index of the first File in a leaf whose name is not less than name
+       */
+      static size_t leafIndex(const Node* leaf, const std::string& name);
+
+      InsertResult insertInto(Node* node, File&& file);
+      bool eraseFrom(Node* node, const std::string& name, File* out);
+
+      /**
+       * @brief Fixes children[index] of parent after it fell below a quarter full, by merging it with
+       *    or borrowing from a neighbouring sibling
+       */
+      static void rebalance(Node* parent, size_t index);
+
+      /**
+       * @brief Deep-copies a subtree. Leaves are appended to the chain ending at *last_leaf.
+       */
+      static std::unique_ptr<Node> clone(const Node* node, Node*& last_leaf);
+
+   public:
+      FileBTree() = default;
+
+      /**
+       * @brief (COPY CONSTRUCTOR) Deep-copies every File and node of rhs
+       */
+      FileBTree(const FileBTree& rhs);
+
+      /**
+       * @brief (COPY ASSIGNMENT) Replaces the tree with a deep copy of rhs
+       */
+      FileBTree& operator=(const FileBTree& rhs);
+
+      /**
+       * @brief (MOVE CONSTRUCTOR / ASSIGNMENT) Takes over rhs's nodes, leaving rhs empty
+       */
+      FileBTree(FileBTree&& rhs) noexcept;
+      FileBTree& operator=(FileBTree&& rhs) noexcept;
+
+      /**
+       * @brief Get the number of Files in the tree
+       */
+      size_t size() const;
+
+      /**
+       * @brief Looks up a File by name
+       * @return A pointer to the File, or nullptr if there is none. Invalidated by the next insert or erase.
+       */
+      File* find(const std::string& name);
+      const File* find(const std::string& name) const;
+
+      /**
+       * @brief Inserts a File in name order
+       *
+       * @param file An r-value reference to the File. It is only moved from if the insert succeeds.
+       * @return A pointer to the inserted File, or nullptr if a File with the same name already exists
+       */
+      File* insert(File&& file);
+
+      /**
+       * @brief Removes the File with the given name
+       *
+       * @param name A const reference to the name of the File to remove
+       * @param out If not nullptr, the removed File is moved here
+       * @return True if a File was removed. False otherwise.
+       */
+      bool erase(const std::string& name, File* out = nullptr);
+
+      /**
+       * @brief Calls visit(file) on every File whose name is not less than first, in name order,
+       *    until visit returns false
+       */
+      template <typename Visit>
+      void forEachFrom(const std::string& first, Visit visit) const {
+         if (!root_) { return; }
+
+         const Node* leaf = findLeaf(first);
+         for (size_t i = leafIndex(leaf, first); leaf != nullptr; leaf = leaf->next, i = 0) {
+            for (; i < leaf->files.size(); ++i) {
+               if (!visit(leaf->files[i])) { return; }
+            }
+         }
+      }
+};
@@ -0,0 +1,70 @@
+#include "FileStore.hpp"
+
+FileStore::FileStore(StorageBackend backend) : backend_(backend) {}
+
+StorageBackend FileStore::getBackend() const {
+   return backend_;
+} // getBackend
+
+size_t FileStore::size() const {
+   return backend_ == StorageBackend::BTree ? tree_.size() : vector_.size();
+} // size
+
+std::vector<File>::iterator FileStore::lowerBound(const std::string& name) {
+   return std::lower_bound(vector_.begin(), vector_.end(), name,
+      [](const File& file, const std::string& target) { return file.getName() < target; });
+} // lowerBound
+
+std::vector<File>::const_iterator FileStore::lowerBound(const std::string& name) const {
+   return std::lower_bound(vector_.begin(), vector_.end(), name,
+      [](const File& file, const std::string& target) { return file.getName() < target; });
+} // lowerBound (const)
+
+File* FileStore::find(const std::string& name) {
+   if (backend_ == StorageBackend::BTree) { return tree_.find(name); }
+
+   auto it = lowerBound(name);
+   if (it == vector_.end() || it->getName() != name) { return nullptr; }
+   return &*it;
+} // find
+
+const File* FileStore::find(const std::string& name) const {
+   return const_cast<FileStore*>(this)->find(name);
+} // find (const)
+
+File* FileStore::insert(File&& file) {
+   if (backend_ == StorageBackend::BTree) { return tree_.insert(std::move(file)); }
+
+   auto it = lowerBound(file.getName());
+   if (it != vector_.end() && it->getName() == file.getName()) { return nullptr; }
+   return &*vector_.insert(it, std::move(file));
+} // insert
+
+bool FileStore::erase(const std::string& name, File* out) {
+   if (backend_ == StorageBackend::BTree) { return tree_.erase(name, out); }
+
+   auto it = lowerBound(name);
+   if (it == vector_.end() || it->getName() != name) { return false; }
+
+   if (out != nullptr) { *out = std::move(*it); }
+   vector_.erase(it);
+   return true;
+} // erase
+
+void FileStore::insertSorted(std::vector<File>& files) {
+   if (backend_ == StorageBackend::BTree) {
+      for (auto it = files.begin(); it != files.end(); ++it) { tree_.insert(std::move(*it)); }
+      files.clear();
+      return;
+   }
+
+   // two-way merge of two sorted, disjoint runs
+   std::vector<File> merged;
+   merged.reserve(vector_.size() + files.size());
+   std::merge(std::make_move_iterator(vector_.begin()), std::make_move_iterator(vector_.end()),
+              std::make_move_iterator(files.begin()), std::make_move_iterator(files.end()),
+              std::back_inserter(merged));
+
+   vector_ = std::move(merged);
+   files.clear();
+} // insertSorted
@@ -0,0 +1,102 @@
+#pragma once
+#include "File.hpp"
+#include "FileBTree.hpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief How a Folder stores its Files
+ *    - Vector: one sorted std::vector. Compact and fastest to iterate, but insert and erase shift every later File.
+ *    - BTree: a FileBTree. O(log N) insert and erase, for folders with heavy churn.
+ */
+enum class StorageBackend { Vector, BTree };
+
+/**
+ * @brief The sorted, duplicate-free collection of Files behind a Folder, backed by either storage backend.
+ * Pointers returned by find() and insert() are invalidated by the next insert or erase.
+ */
+class FileStore {
+   private:
+      StorageBackend backend_;
+      std::vector<File> vector_;
+      FileBTree tree_;
+
+      /**
+       * @brief Finds the first file in vector_ whose name is not less than the given name
+       */
+      std::vector<File>::iterator lowerBound(const std::string& name);
+      std::vector<File>::const_iterator lowerBound(const std::string& name) const;
+
+   public:
+      /**
+       * @brief Construct a new, empty FileStore using the given backend
+       */
+      FileStore(StorageBackend backend = StorageBackend::Vector);
+
+      /**
+       * @brief Get the backend chosen at construction
+       */
+      StorageBackend getBackend() const;
+
+      /**
+       * @brief Get the number of Files stored
+       */
+      size_t size() const;
+
+      /**
+       * @brief Looks up a File by name
+       * @return A pointer to the File, or nullptr if there is none
+       */
+      File* find(const std::string& name);
+      const File* find(const std::string& name) const;
+
+      /**
+       * @brief Inserts a File in name order
+       *
+       * @param file An r-value reference to the File. It is only moved from if the insert succeeds.
+       * @return A pointer to the inserted File, or nullptr if a File with the same name already exists
+       */
+      File* insert(File&& file);
+
+      /**
+       * @brief Removes the File with the given name
+       *
+       * @param name A const reference to the name of the File to remove
+       * @param out If not nullptr, the removed File is moved here
+       * @return True if a File was removed. False otherwise.
+       */
+      bool erase(const std::string& name, File* out = nullptr);
+
+      /**
+       * @brief Inserts a batch of Files which is already sorted, free of duplicates, and disjoint from the store
+       * The vector backend merges the batch in a single linear pass.
+       *
+       * @param files A reference to the batch. Left empty.
+       */
+      void insertSorted(std::vector<File>& files);
+
+      /**
+       * @brief Calls visit(file) on every File whose name is not less than first, in name order,
+       *    until visit returns false
+       */
+      template <typename Visit>
+      void forEachFrom(const std::string& first, Visit visit) const {
+         if (backend_ == StorageBackend::BTree) {
+            tree_.forEachFrom(first, visit);
+            return;
+         }
+
+         for (auto it = lowerBound(first); it != vector_.end(); ++it) {
+            if (!visit(*it)) { return; }
+         }
+      }
+
+      /**
+       * @brief Calls visit(file) on every File in name order, until visit returns false
+       */
+      template <typename Visit>
+      void forEach(Visit visit) const {
+         forEachFrom("", visit);
+      }
+};
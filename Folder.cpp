@@ -61,10 +61,12 @@ bool Folder::rename(const std::string& name) {
 *    However, we'll hold off on that for now, since we just want to get used to iterating with iterators.
 */
 void Folder::display() {
-   std::sort(files_.begin(), files_.end());
-
+   // files_ is always kept in sorted order, so no sort is needed here
    std::cout << getName() << std::endl;
-   for (auto it = files_.begin(); it != files_.end(); ++it) { std::cout << "   " << it->getName() << std::endl; }
+   files_.forEach([](const File& file) {
+      std::cout << "   " << file.getName() << std::endl;
+      return true;
+   });
 }
 
 //                       DO NOT EDIT ABOVE THIS LINE. 
@@ -72,12 +74,21 @@ void Folder::display() {
 //    That also means includes. Remember, all other includes go in .hpp
 // =========================== YOUR CODE HERE ===========================
 
+Folder::Folder(const std::string& name, StorageBackend backend) : Folder(name) {
+   files_ = FileStore(backend);
+} // Constructor (with backend)
+
+StorageBackend Folder::getBackend() const {
+   return files_.getBackend();
+} // getBackend
+
 size_t Folder::getSize() const {
    size_t result = 0;
 
-   for (auto it = files_.begin() ; it != files_.end() ; ++it) {
-      result += it->getSize();
-   }
+   files_.forEach([&result](const File& file) {
+      result += file.getSize();
+      return true;
+   });
 
    return result;
 } // getSize
@@ -87,67 +98,25 @@ bool Folder::addFile(File& new_file) {
    if (new_file.getName() == "") {
       return false;
    }
-   
-   //if empty folder, skip the binary search & add
-   if (files_.empty()) {
-      files_.push_back(std::move(new_file));
-      return true;
-   }
 
-   //no duplicates allowed -> sort then binary sesarch
-   std::sort(files_.begin(), files_.end());
-
-   auto i = files_.begin();
-   auto j = files_.end() - 1;
-   std::vector<File>::iterator mid;
-
-   while (i <= j) {
-      mid = i + std::distance(i, j) / 2;
-
-      if (mid->getName() == new_file.getName()) {
-         //prevents duplicates
-         return false; 
-      } else if (new_file < *mid) {
-         //if on left side
-         j = mid - 1;
-      } else { //new_file > files_[mid]
-         //on right side
-         i = mid + 1;
-      }
-      //if mid variable updated at bottom of loop then mid can be used to insert
+   //no duplicates allowed; files_ finds the sorted position with a binary search
+   if (files_.find(new_file.getName()) != nullptr) {
+      return false;
    }
 
-   //if goes past while loop -> (i > j) & not duplicate, so insert
-   //   cant use mid to insert because mid won't be updated after breaking out while loop
-   files_.insert(i, std::move(new_file));
-
+   indexFile(new_file);
+   files_.insert(std::move(new_file));
    return true;
 } // addFile
 
 bool Folder::removeFile(const std::string& name) {
-   //binary search for file name
-   auto i = files_.begin();
-   auto j = files_.end() - 1;
-   std::vector<File>::iterator mid;
-
-   while (i <= j) {
-      mid = i + std::distance(i, j) / 2;
-
-      if (mid->getName() == name) {
-         //matching name -> file exists in directory so delete it
-         files_.erase(mid);
-         return true;
-      } else if (name < mid->getName()) {
-         //if on left side
-         j = mid - 1;
-      } else { //name > mid->getName()
-         //on right side
-         i = mid + 1;
-      }
+   if (!files_.erase(name)) {
+      // no matching name found
+      return false;
    }
 
-   // reaches this point if no matching name found
-   return false;
+   unindexFile(name);
+   return true;
 } // removeFile
 
 bool Folder::moveFileTo(const std::string& name, Folder& destination) {
@@ -156,103 +125,199 @@ bool Folder::moveFileTo(const std::string& name, Folder& destination) {
       return true;
    }
 
-   if (!destination.files_.empty()) {
-      // binary search destination folder for same name
-      auto i2 = destination.files_.begin();
-      auto j2 = destination.files_.end() - 1;
-      std::vector<File>::iterator mid2;
-
-      while (i2 <= j2) {
-         mid2 = i2 + std::distance(i2, j2) / 2;
-
-         if (mid2->getName() == name) {
-            //matching name -> cannot move if dupe name
-            return false;
-         } else if (name < mid2->getName()) {
-            //if on left side
-            j2 = mid2 - 1;
-         } else { //name > mid2->getName()
-            //on right side
-            i2 = mid2 + 1;
-         }
-      }
+   // cannot move if dupe name in destination, or if not found in current folder
+   if (destination.files_.find(name) != nullptr || this->files_.find(name) == nullptr) {
+      return false;
    }
 
-   if (!this->files_.empty()) {
-      // binary search current directory for matching name
-      auto i = files_.begin();
-      auto j = files_.end() - 1;
-      std::vector<File>::iterator mid;
-
-      while (i <= j) {
-         mid = i + std::distance(i, j) / 2;
-
-         if (mid->getName() == name) {
-            // matching name -> move to dest. & erase from current directory
-            destination.files_.push_back(std::move(*mid));
-            this->files_.erase(mid);
-            return true;
-         } else if (name < mid->getName()) {
-            //if on left side
-            j = mid - 1;
-         } else { //name > mid->getName()
-            //on right side
-            i = mid + 1;
-         }
-      }
-   }
+   // index in dest. first: reading a lazy file's contents can throw, and then the file must stay where it is
+   destination.indexFile(*this->files_.find(name));
 
-   // return false if not found current folder 
-   return false;
+   // matching name -> take it out of the current directory & move it to dest. (in sorted position)
+   File moved;
+   this->files_.erase(name, &moved);
+   this->unindexFile(name);
+   destination.files_.insert(std::move(moved));
+   return true;
 } // moveFileTo
 
 bool Folder::copyFileTo(const std::string& name, Folder& destination) {
-   if (!destination.files_.empty()) {
-      // binary search dest. folder, make sure file with same name doesn't exist already
-      auto i2 = destination.files_.begin();
-      auto j2 = destination.files_.end() - 1;
-      std::vector<File>::iterator mid2;
-
-      while (i2 <= j2) {
-         mid2 = i2 + std::distance(i2, j2) / 2;
-
-         if (mid2->getName() == name) {
-            //matching name -> cannot copy to destination
-            return false;
-         } else if (name < mid2->getName()) {
-            //if on left side
-            j2 = mid2 - 1;
-         } else { //name > mid2->getName()
-            //on right side
-            i2 = mid2 + 1;
-         }
-      }
+   // make sure file with same name doesn't exist already in dest. folder
+   if (destination.files_.find(name) != nullptr) {
+      return false;
    }
-   
-   if (!this->files_.empty()) {
-      // binary search curr folder, make sure file with given name exists in curr. directory
-      auto i = files_.begin();
-      auto j = files_.end() - 1;
-      std::vector<File>::iterator mid;
-
-      while (i <= j) {
-         mid = i + std::distance(i, j) / 2;
-
-         if (mid->getName() == name) {
-            //matching name -> create copy with copy constructor and push_back
-            File file_to_add(*mid); 
-            destination.files_.push_back(file_to_add);
-            return true;
-         } else if (name < mid->getName()) {
-            //if on left side
-            j = mid - 1;
-         } else { //name > mid->getName()
-            //on right side
-            i = mid + 1;
-         }
-      }
+
+   // make sure file with given name exists in curr. directory
+   const File* source = this->files_.find(name);
+   if (source == nullptr) {
+      return false;
    }
 
-   // return false if not found current folder 
-   return false;
+   //matching name -> create copy with copy constructor and insert in sorted position
+   File file_to_add(*source);
+   destination.indexFile(file_to_add);
+   destination.files_.insert(std::move(file_to_add));
+   return true;
 } // copyFileTo
+
+size_t Folder::addFiles(std::vector<File>& new_files) {
+   std::sort(new_files.begin(), new_files.end());
+
+   // keep only the first of each name, and only names not already in the folder
+   std::vector<File> accepted;
+   std::vector<size_t> origin; // where each accepted file sat in new_files, to put it back if indexing fails
+   accepted.reserve(new_files.size());
+   origin.reserve(new_files.size());
+   try {
+      for (size_t i = 0; i < new_files.size(); ++i) {
+         std::string name = new_files[i].getName();
+         if (name == "") { continue; }
+         if (!accepted.empty() && accepted.back().getName() == name) { continue; } // duplicate in batch
+         if (files_.find(name) != nullptr) { continue; } // already in folder
+
+         indexFile(new_files[i]);
+         accepted.push_back(std::move(new_files[i]));
+         origin.push_back(i);
+      }
+   } catch (std::runtime_error&) {
+      for (size_t a = 0; a < accepted.size(); ++a) {
+         unindexFile(accepted[a].getName());
+         new_files[origin[a]] = std::move(accepted[a]);
+      }
+      throw;
+   }
+
+   size_t added = accepted.size();
+   files_.insertSorted(accepted);
+   new_files.clear();
+   return added;
+} // addFiles
+
+std::vector<std::string> Folder::getNamesWithPrefix(const std::string& prefix) const {
+   std::vector<std::string> result;
+
+   files_.forEachFrom(prefix, [&](const File& file) {
+      std::string name = file.getName();
+      // sorted order -> the first name without the prefix ends the run
+      if (name.compare(0, prefix.size(), prefix) != 0) { return false; }
+      result.push_back(std::move(name));
+      return true;
+   });
+
+   return result;
+} // getNamesWithPrefix
+
+std::vector<std::string> Folder::getNamesInRange(const std::string& first, const std::string& last) const {
+   std::vector<std::string> result;
+   if (!(first < last)) { return result; }
+
+   files_.forEachFrom(first, [&](const File& file) {
+      std::string name = file.getName();
+      if (!(name < last)) { return false; }
+      result.push_back(std::move(name));
+      return true;
+   });
+
+   return result;
+} // getNamesInRange
+
+std::vector<std::string> Folder::getNamesWithExtension(const std::string& extension) const {
+   std::string key = (!extension.empty() && extension[0] == '.') ? extension.substr(1) : extension;
+
+   auto found = extension_index_.find(key);
+   if (found == extension_index_.end()) { return {}; }
+   return std::vector<std::string>(found->second.begin(), found->second.end());
+} // getNamesWithExtension
+
+const File* Folder::getFile(const std::string& name) const {
+   return files_.find(name);
+} // getFile
+
+std::string Folder::extensionOf(const std::string& filename) {
+   size_t period = filename.find('.');
+   return period == std::string::npos ? "" : filename.substr(period + 1);
+} // extensionOf
+
+void Folder::indexFile(const File& file) {
+   // the content index goes first, since loading a lazy file's contents is the step that can throw
+   if (content_indexed_) { content_index_.add(file); }
+   extension_index_[extensionOf(file.getName())].insert(file.getName());
+} // indexFile
+
+void Folder::unindexFile(const std::string& name) {
+   if (content_indexed_) { content_index_.remove(name); }
+
+   auto found = extension_index_.find(extensionOf(name));
+   if (found == extension_index_.end()) { return; }
+
+   found->second.erase(name);
+   if (found->second.empty()) { extension_index_.erase(found); }
+} // unindexFile
+
+void Folder::enableContentIndex() {
+   if (content_indexed_) { return; }
+
+   try {
+      files_.forEach([this](const File& file) {
+         content_index_.add(file);
+         return true;
+      });
+   } catch (std::runtime_error&) {
+      content_index_.clear(); // a partial index would hide files from searches
+      throw;
+   }
+   content_indexed_ = true;
+   content_index_.shrinkToFit();
+} // enableContentIndex
+
+void Folder::disableContentIndex() {
+   content_indexed_ = false;
+   content_index_.clear();
+} // disableContentIndex
+
+bool Folder::hasContentIndex() const {
+   return content_indexed_;
+} // hasContentIndex
+
+size_t Folder::getContentIndexBytes() const {
+   return content_indexed_ ? content_index_.getMemoryBytes() : 0;
+} // getContentIndexBytes
+
+bool Folder::setFileContents(const std::string& name, const std::string& new_contents) {
+   File* file = files_.find(name);
+   if (file == nullptr) { return false; }
+
+   file->setContents(new_contents);
+   if (content_indexed_) { content_index_.add(name, new_contents); } // replaces the old entry
+   return true;
+} // setFileContents
+
+std::vector<std::string> Folder::searchContents(const std::string& text) const {
+   return search(text, false);
+} // searchContents
+
+std::vector<std::string> Folder::searchTerm(const std::string& term) const {
+   return search(term, true);
+} // searchTerm
+
+std::vector<std::string> Folder::search(const std::string& text, bool whole_word) const {
+   std::vector<std::string> result;
+
+   if (!content_indexed_ || text.size() < ContentIndex::GRAM) {
+      // no index, or nothing it can look up -> check every file
+      files_.forEach([&](const File& file) {
+         if (file.contains(text, whole_word)) { result.push_back(file.getName()); }
+         return true;
+      });
+      return result;
+   }
+
+   // the index only narrows things down, so verify each candidate against its contents
+   for (const std::string& name : content_index_.candidates(text)) {
+      const File* file = files_.find(name);
+      if (file != nullptr && file->contains(text, whole_word)) {
+         result.push_back(name);
+      }
+   }
+   return result;
+} // search
@@ -1,15 +1,19 @@
 #pragma once
 #include "File.hpp"
 #include "InvalidFormatException.hpp"
+#include "ContentIndex.hpp"
+#include "FileStore.hpp"
 #include <algorithm>
 #include <vector>
 #include <iostream>
 #include <iterator>
+#include <set>
+#include <unordered_map>
 
 class Folder {
    private:
       std::string name_;
-      std::vector<File> files_;
+      FileStore files_;
 
    public:
       /**
@@ -36,7 +40,7 @@ class Folder {
       bool rename(const std::string& name);
 
       /**
-       * @brief Sorts and prints the names of subfolder and file vectors lexicographically (ie. alphabetically)
+       * @brief Prints the names of the files in files_ lexicographically (ie. alphabetically); files_ is always kept in that order
        * The contents of subfolders are also printed.
        * Reference the following format (using 3 spaces to indent each directory layer)
        * (FOLDER) <CURRENT_FOLDER_NAME> 
@@ -53,25 +57,40 @@ class Folder {
       // =========================== YOUR CODE HERE ===========================
 
       /**
-      * @brief Iterate through the files vector, calculating the total size of all child files
+      * @brief Construct a new Folder object with the given storage backend
+      * @param name A string with alphanumeric characters, validated exactly as by the constructor above
+      * @param backend StorageBackend::Vector (the default for the constructor above) or StorageBackend::BTree, 
+      *    which keeps inserts and erases O(log N) on folders with many files
+      * @throw If the name is invalid (eg. contains non-alphanumeric characters) an InvalidFormatException is thrown
+      */
+      Folder(const std::string& name, StorageBackend backend);
+
+      /**
+       * @brief Get the storage backend chosen at construction
+       */
+      StorageBackend getBackend() const;
+
+      /**
+      * @brief Iterate through files_ (the FileStore), calculating the total size of all child files
       * @return size_t The total size of all child files
       */
       size_t getSize() const;
       
       /**
-      * @brief Appends the given file to the files_ vector using move_semantics on the parameter File object, if a file with the same name does not exist within the files_ vector
-       *    (HINT!) Consider push_back(). What happens when we give it an l-value vs. an r-value? Does it change anything?
+      * @brief Moves the given file into files_ at its sorted position (FileStore::insert), if a file with the same name does not exist within files_
+       *    O(log N) to find the position; the Vector backend then shifts every later file, the BTree backend at most one node.
        * 
        * @param new_file A reference to a File object to be added. If the name of the File object is empty (ie. its contents have been taken via move) the add fails  
        * @return True if the file was added successfully. False otherwise.
        * @post If the file was added, leaves the parameter File object in a valid but unspecified state
+       * @throws std::runtime_error If the content index is enabled and a lazy file's contents cannot be read.
+       *    Nothing is changed in that case.
        */
       bool addFile(File& new_file);
 
       /**
-       * @brief Searches for a file within the files_ vector to be deleted.
-       * If a file object with a matching name is found, erase it from the vector in linear [O(N)] time or better.
-       * Order does not matter.
+       * @brief Searches for a file within files_ to be deleted.
+       * If a file object with a matching name is found, erase it from files_, keeping the remaining files sorted.
        * 
        * @param name A const reference to a string representing the filename to be deleted
        * @return True if the file was found & successfully deleted. 
@@ -80,7 +99,7 @@ class Folder {
 
       /**
        * @brief Moves a file from the current folder to a specified folder 
-       * If a matching name is found, use move semantics to move the object from the current directory to the file vector within the destination folder'
+       * If a matching name is found, use move semantics to move the object from the current directory into files_ of the destination folder
        *    and erase it from the current folder. 
        * If a matching name is not found within the source folder or an object with the same name already exists within the 
        *    destination folder, nothing is moved.
@@ -89,6 +108,8 @@ class Folder {
        * @param name The name of the file to be moved, as a const reference to a string
        * @param destination The target folder to be moved to, as a reference to a Folder object
        * @return True if the file was moved successfully. False otherwise.
+       * @throws std::runtime_error If the destination has a content index and a lazy file's contents cannot be read.
+       *    The file stays in the current folder in that case.
        */
       bool moveFileTo(const std::string& name, Folder& destination);
 
@@ -103,6 +124,132 @@ class Folder {
          * @param name The name of the copied object, as a const string reference
          * @param destination The destination folder, as a reference to a Folder object
          * @return True if the file was copied successfully. False otherwise.
+         * @throws std::runtime_error If the destination has a content index and a lazy file's contents cannot be read.
+         *    Nothing is changed in that case.
          */
       bool copyFileTo(const std::string& name, Folder& destination);
+
+      /**
+       * @brief Bulk-loads a batch of files into files_, keeping it in sorted order.
+       * The batch is sorted once; with the Vector backend it is then merged with the existing files in a single 
+       *    linear pass, instead of paying a vector shift per file as repeated addFile() calls would.
+       * Files with an empty name, or whose name already exists (in the folder or earlier in the batch), are skipped.
+       * 
+       * @param new_files A reference to a vector of File objects to be added
+       * @return size_t The number of files that were added
+       * @post Added files are moved from, and new_files is left empty
+       * @throws std::runtime_error If the content index is enabled and a lazy file's contents cannot be read.
+       *    Nothing is added in that case, and new_files keeps every file (sorted).
+       */
+      size_t addFiles(std::vector<File>& new_files);
+
+      /**
+       * @brief Lists every filename starting with the given prefix, in sorted order, in O(log N + K) time.
+       * 
+       * @param prefix A const reference to the prefix to match. An empty prefix matches every file.
+       * @return std::vector<std::string> The matching filenames
+       */
+      std::vector<std::string> getNamesWithPrefix(const std::string& prefix) const;
+
+      /**
+       * @brief Lists every filename within the half-open interval [first, last), in sorted order, in O(log N + K) time.
+       * 
+       * @param first A const reference to the inclusive lower bound
+       * @param last A const reference to the exclusive upper bound
+       * @return std::vector<std::string> The matching filenames. Empty if last <= first.
+       */
+      std::vector<std::string> getNamesInRange(const std::string& first, const std::string& last) const;
+
+      /**
+       * @brief Lists every filename with the given extension, in sorted order, using the per-extension index (no scan of files_).
+       * 
+       * @param extension A const reference to the extension, with or without the leading period (eg. "log" or ".log")
+       * @return std::vector<std::string> The matching filenames
+       */
+      std::vector<std::string> getNamesWithExtension(const std::string& extension) const;
+
+      /**
+       * @brief Builds a trigram index over the contents of every file in the folder, and keeps it up to date 
+       *    as files are added, removed, moved, copied or changed through setFileContents().
+       * Does nothing if the index is already enabled.
+       * @throws std::runtime_error If a lazy file's contents cannot be read. The index stays disabled in that case.
+       */
+      void enableContentIndex();
+
+      /**
+       * @brief Drops the content index. Content searches fall back to scanning every file.
+       */
+      void disableContentIndex();
+
+      /**
+       * @brief Returns true if the content index is enabled
+       */
+      bool hasContentIndex() const;
+
+      /**
+       * @brief Get the approximate memory held by the content index, in bytes. 0 if it is disabled.
+       */
+      size_t getContentIndexBytes() const;
+
+      /**
+       * @brief Replaces the contents of the file with the given name, updating the content index if enabled
+       * 
+       * @param name A const reference to the name of the file to change
+       * @param new_contents A const reference to the new contents
+       * @return True if the file was found and changed. False otherwise.
+       */
+      bool setFileContents(const std::string& name, const std::string& new_contents);
+
+      /**
+       * @brief Lists the files whose contents contain the given text anywhere (substring match)
+       * 
+       * @param text A const reference to the text to search for
+       * @return std::vector<std::string> The matching filenames, in sorted order
+       */
+      std::vector<std::string> searchContents(const std::string& text) const;
+
+      /**
+       * @brief Lists the files whose contents contain the given term as a whole word 
+       *    (ie. not directly preceded or followed by an alphanumeric character)
+       * 
+       * @param term A const reference to the term to search for
+       * @return std::vector<std::string> The matching filenames, in sorted order
+       */
+      std::vector<std::string> searchTerm(const std::string& term) const;
+
+      /**
+       * @brief Looks up a file by name without copying it
+       * 
+       * @param name A const reference to the filename
+       * @return const File* A pointer to the file, or nullptr if no file has that name. 
+       *    Invalidated by any later change to the folder.
+       */
+      const File* getFile(const std::string& name) const;
+
+   private:
+      ContentIndex content_index_;
+      bool content_indexed_ = false;
+
+      // extension (without the period) -> names of the files in files_ carrying it
+      std::unordered_map<std::string, std::set<std::string>> extension_index_;
+
+      /**
+       * @brief Returns the part of a filename after its period, or an empty string if there is none
+       */
+      static std::string extensionOf(const std::string& filename);
+
+      /**
+       * @brief Adds a file to extension_index_ (and content_index_ when enabled)
+       */
+      void indexFile(const File& file);
+
+      /**
+       * @brief Removes a filename from extension_index_ (and content_index_ when enabled)
+       */
+      void unindexFile(const std::string& name);
+
+      /**
+       * @brief Shared body of searchContents() and searchTerm()
+       */
+      std::vector<std::string> search(const std::string& text, bool whole_word) const;
 };
\ No newline at end of file
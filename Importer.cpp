@@ -0,0 +1,148 @@
+#include "Importer.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+
+double ImportStats::filesPerSecond() const {
+   return seconds > 0.0 ? files_imported / seconds : 0.0;
+}
+
+double ImportStats::megabytesPerSecond() const {
+   return seconds > 0.0 ? (bytes_read / 1e6) / seconds : 0.0;
+}
+
+Importer::Importer(size_t num_threads, bool recursive) : num_threads_(num_threads), recursive_(recursive) {
+   if (num_threads_ == 0) {
+      num_threads_ = DEFAULT_THREADS;
+   }
+}
+
+size_t Importer::getNumThreads() const {
+   return num_threads_;
+}
+
+ImportStats Importer::getStats() const {
+   return stats_;
+}
+
+bool Importer::readWholeFile(const std::string& path, std::string& body) {
+   int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+   if (fd < 0) { return false; }
+
+   struct stat st;
+   if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+      ::close(fd);
+      return false;
+   }
+   size_t size = static_cast<size_t>(st.st_size);
+
+   body.resize(size);
+   size_t done = 0;
+   while (done < size) {
+      ssize_t n = ::pread(fd, &body[done], size - done, static_cast<off_t>(done));
+      if (n < 0 && errno == EINTR) { continue; }
+      if (n <= 0) { break; } // error, or the file shrank underneath us
+      done += static_cast<size_t>(n);
+   }
+   ::close(fd);
+
+   body.resize(done);
+   return done == size;
+} // readWholeFile
+
+std::vector<Folder> Importer::importDirectory(const std::string& root_path) {
+   namespace fs = std::filesystem;
+   stats_ = ImportStats();
+   auto start = std::chrono::steady_clock::now();
+
+   std::error_code ec;
+   if (!fs::is_directory(root_path, ec)) {
+      throw InvalidFormatException("Not a directory: " + root_path);
+   }
+
+   std::vector<Folder> folders;
+   std::vector<PendingFile> pending;
+   std::set<std::string> used_names;
+
+   // walk the tree (single-threaded; directory listing is cheap next to reading bodies)
+   std::vector<fs::path> dirs { fs::path(root_path) };
+   for (size_t d = 0; d < dirs.size(); ++d) {
+      fs::path normal = fs::absolute(dirs[d], ec).lexically_normal();
+      std::string dir_name = normal.filename().string();
+      if (dir_name.empty()) { dir_name = normal.parent_path().filename().string(); } // trailing slash, "." or ".."
+
+      try {
+         Folder probe(dir_name);
+      } catch (InvalidFormatException&) {
+         if (d != 0) {
+            ++stats_.folders_skipped;
+            continue;
+         }
+         dir_name = ""; // the root is always imported, under the default name if need be
+      }
+
+      // keep folder names unique, since Folder::moveFileTo treats equal names as the same folder
+      std::string base_name = Folder(dir_name).getName();
+      std::string unique_name = base_name;
+      for (size_t suffix = 2; !used_names.insert(unique_name).second; ++suffix) {
+         unique_name = base_name + std::to_string(suffix);
+      }
+      if (unique_name != base_name) { ++stats_.folders_renamed; }
+      folders.emplace_back(unique_name);
+      size_t folder_index = folders.size() - 1;
+
+      for (const auto& entry : fs::directory_iterator(dirs[d], ec)) {
+         if (entry.is_directory(ec)) {
+            // don't follow directory symlinks, they can loop
+            if (recursive_ && !entry.is_symlink(ec)) { dirs.push_back(entry.path()); }
+         } else if (entry.is_regular_file(ec)) {
+            std::string name = entry.path().filename().string();
+            try {
+               File probe(name); // validate before paying for the read
+               pending.push_back({entry.path().string(), name, folder_index});
+            } catch (InvalidFormatException&) {
+               ++stats_.files_skipped;
+            }
+         }
+      }
+   }
+
+   // read bodies with a pool of workers; each slot is written by exactly one worker
+   std::vector<std::string> bodies(pending.size());
+   std::vector<char> ok(pending.size(), 0);
+   std::atomic<size_t> next { 0 };
+
+   auto worker = [&]() {
+      for (size_t i = next++; i < pending.size(); i = next++) {
+         ok[i] = readWholeFile(pending[i].path, bodies[i]);
+      }
+   };
+
+   std::vector<std::thread> pool;
+   size_t n_threads = std::min(num_threads_, std::max<size_t>(1, pending.size()));
+   for (size_t t = 1; t < n_threads; ++t) { pool.emplace_back(worker); }
+   worker();
+   for (auto& th : pool) { th.join(); }
+
+   // group per folder, then bulk-load each one in sorted order
+   std::vector<std::vector<File>> batches(folders.size());
+   for (size_t i = 0; i < pending.size(); ++i) {
+      if (!ok[i]) {
+         ++stats_.files_skipped;
+         continue;
+      }
+      stats_.bytes_read += bodies[i].size();
+      batches[pending[i].folder_index].emplace_back(pending[i].name, std::move(bodies[i]));
+   }
+
+   for (size_t f = 0; f < folders.size(); ++f) {
+      size_t batch_size = batches[f].size();
+      size_t added = folders[f].addFiles(batches[f]);
+      stats_.files_imported += added;
+      stats_.files_skipped += batch_size - added;
+   }
+
+   stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+   return folders;
+} // importDirectory
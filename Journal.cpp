@@ -0,0 +1,574 @@
+#include "Journal.hpp"
+#include <fstream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+   const char SNAPSHOT_MAGIC[8] = { 'F', 'O', 'L', 'D', 'S', 'N', 'A', 'P' };
+   const size_t HEADER_BYTES = 8;  // u32 length + u32 crc
+   const size_t ICON_INTS = 256;   // File::ICON_DIM
+
+   void putU8(std::string& out, uint8_t value) {
+      out.push_back(static_cast<char>(value));
+   }
+
+   void putU32(std::string& out, uint32_t value) {
+      for (int i = 0; i < 4; ++i) { out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF)); }
+   }
+
+   void putU64(std::string& out, uint64_t value) {
+      for (int i = 0; i < 8; ++i) { out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF)); }
+   }
+
+   void putString(std::string& out, const std::string& value) {
+      putU32(out, static_cast<uint32_t>(value.size()));
+      out += value;
+   }
+
+   void putFile(std::string& out, const File& file) {
+      putString(out, file.getName());
+      file.visitContents([&out](const std::string& contents) { putString(out, contents); });
+      int* icon = file.getIcon();
+      putU8(out, icon != nullptr);
+      if (icon != nullptr) {
+         for (size_t i = 0; i < ICON_INTS; ++i) { putU32(out, static_cast<uint32_t>(icon[i])); }
+      }
+   }
+
+   // Bounds-checked little-endian decoder; any overrun clears ok
+   struct Reader {
+      const std::string& data;
+      size_t pos;
+      size_t end;
+      bool ok = true;
+
+      uint64_t getUnsigned(size_t bytes) {
+         if (!ok || end - pos < bytes) {
+            ok = false;
+            return 0;
+         }
+         uint64_t value = 0;
+         for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+         }
+         pos += bytes;
+         return value;
+      }
+
+      std::string getString() {
+         size_t size = getUnsigned(4);
+         if (!ok || end - pos < size) {
+            ok = false;
+            return "";
+         }
+         std::string value = data.substr(pos, size);
+         pos += size;
+         return value;
+      }
+   };
+
+   // Writes all of data, retrying short writes. Returns false with errno set on failure.
+   bool writeFully(int fd, const char* data, size_t size) {
+      size_t done = 0;
+      while (done < size) {
+         ssize_t n = ::write(fd, data + done, size - done);
+         if (n < 0 && errno == EINTR) { continue; }
+         if (n <= 0) { return false; }
+         done += static_cast<size_t>(n);
+      }
+      return true;
+   }
+
+   // Frames snapshot records straight into a write buffer, which goes out to fd whenever it passes FLUSH_BYTES,
+   //    so memory use is bounded by the largest file rather than by the size of the whole snapshot
+   class SnapshotWriter {
+      private:
+         static const size_t FLUSH_BYTES = 1 << 20;
+         int fd_;
+         std::string buffer_;
+         size_t start_ = 0;
+
+      public:
+         explicit SnapshotWriter(int fd) : fd_(fd) {}
+
+         // Starts a record and returns the buffer to serialize its payload into
+         std::string& beginRecord() {
+            start_ = buffer_.size();
+            buffer_.append(HEADER_BYTES, '\0');
+            putU64(buffer_, 0); // snapshot records use sequence number 0
+            return buffer_;
+         }
+
+         // Fills in the length and checksum of the record started last
+         void endRecord() {
+            size_t body = start_ + HEADER_BYTES;
+            std::string header;
+            putU32(header, static_cast<uint32_t>(buffer_.size() - body));
+            putU32(header, Journal::crc32(buffer_.data() + body, buffer_.size() - body));
+            buffer_.replace(start_, HEADER_BYTES, header);
+            if (buffer_.size() >= FLUSH_BYTES) { flush(); }
+         }
+
+         void write(const std::string& data) {
+            buffer_ += data;
+            if (buffer_.size() >= FLUSH_BYTES) { flush(); }
+         }
+
+         void flush() {
+            if (!writeFully(fd_, buffer_.data(), buffer_.size())) {
+               throw std::runtime_error("Snapshot write failed: " + std::string(std::strerror(errno)));
+            }
+            buffer_.clear();
+         }
+   };
+
+   // Checks the magic at the start of a snapshot and returns the sequence number it covers
+   uint64_t snapshotSeq(const std::string& path, const std::string& snapshot) {
+      if (snapshot.size() < sizeof(SNAPSHOT_MAGIC) + 8 || std::memcmp(snapshot.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+         throw std::runtime_error("Bad snapshot header in " + path);
+      }
+      Reader header { snapshot, sizeof(SNAPSHOT_MAGIC), snapshot.size() };
+      return header.getUnsigned(8);
+   }
+
+   Folder& folderNamed(std::map<std::string, Folder>& folders, const std::string& name) {
+      return folders.try_emplace(name, name).first->second;
+   }
+}
+
+uint32_t Journal::crc32(const char* data, size_t size) {
+   static const std::vector<uint32_t> table = []() {
+      std::vector<uint32_t> t(256);
+      for (uint32_t i = 0; i < 256; ++i) {
+         uint32_t c = i;
+         for (int k = 0; k < 8; ++k) { c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1; }
+         t[i] = c;
+      }
+      return t;
+   }();
+
+   uint32_t crc = 0xFFFFFFFFu;
+   for (size_t i = 0; i < size; ++i) {
+      crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+   }
+   return crc ^ 0xFFFFFFFFu;
+} // crc32
+
+Journal::Journal(const std::string& path, SyncMode mode, size_t max_batch, std::chrono::microseconds max_delay, size_t checkpoint_bytes)
+   : path_(path), snapshot_path_(path + ".snapshot"), mode_(mode), max_batch_(std::max<size_t>(1, max_batch)),
+     max_delay_(max_delay), checkpoint_bytes_(checkpoint_bytes) {
+   fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+   if (fd_ < 0) {
+      throw std::runtime_error("Cannot open journal " + path_ + ": " + std::strerror(errno));
+   }
+
+   try {
+      recover();
+   } catch (std::runtime_error&) {
+      ::close(fd_);
+      throw;
+   }
+
+   if (mode_ != SyncMode::PerOp) {
+      flusher_ = std::thread(&Journal::flushLoop, this);
+   }
+} // Constructor
+
+void Journal::recover() {
+   uint64_t snapshot_seq = 0;
+   std::ifstream snapshot(snapshot_path_, std::ios::binary);
+   if (snapshot) {
+      std::string header(sizeof(SNAPSHOT_MAGIC) + 8, '\0');
+      snapshot.read(&header[0], header.size());
+      header.resize(static_cast<size_t>(snapshot.gcount()));
+      snapshot_seq = snapshotSeq(snapshot_path_, header);
+   }
+
+   // validate without applying, to find the last good record
+   uint64_t last_seq = 0;
+   size_t applied = 0;
+   size_t valid = applyRecords(path_, 0, nullptr, 0, last_seq, applied);
+
+   if (valid < static_cast<size_t>(::lseek(fd_, 0, SEEK_END))) {
+      // cut the torn tail off now, or records appended after it would be unreachable on replay
+      if (::ftruncate(fd_, static_cast<off_t>(valid)) != 0 || ::fsync(fd_) != 0) {
+         throw std::runtime_error("Cannot truncate journal " + path_ + ": " + std::strerror(errno));
+      }
+   }
+
+   journal_bytes_ = valid;
+   next_seq_ = std::max(last_seq, snapshot_seq) + 1;
+   durable_seq_ = next_seq_ - 1;
+} // recover
+
+Journal::~Journal() {
+   try {
+      sync();
+   } catch (std::runtime_error&) {
+      // nothing sensible left to do with the error during destruction
+   }
+
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+   }
+   work_cv_.notify_one();
+   if (flusher_.joinable()) { flusher_.join(); }
+
+   ::close(fd_);
+} // Destructor
+
+void Journal::writeAndSync(const std::string& data) {
+   if (!writeFully(fd_, data.data(), data.size())) {
+      throw std::runtime_error("Journal write failed: " + std::string(std::strerror(errno)));
+   }
+
+#if defined(__linux__)
+   int rc = ::fdatasync(fd_);
+#else
+   int rc = ::fsync(fd_);
+#endif
+   if (rc != 0) { throw std::runtime_error("Journal sync failed: " + std::string(std::strerror(errno))); }
+} // writeAndSync
+
+void Journal::append(std::string payload) {
+   std::unique_lock<std::mutex> lock(mutex_);
+   if (!error_.empty()) { throw std::runtime_error(error_); }
+
+   uint64_t seq = next_seq_++;
+   std::string body;
+   body.reserve(8 + payload.size());
+   putU64(body, seq);
+   body += payload;
+
+   std::string record;
+   record.reserve(HEADER_BYTES + body.size());
+   putU32(record, static_cast<uint32_t>(body.size()));
+   putU32(record, crc32(body.data(), body.size()));
+   record += body;
+   journal_bytes_ += record.size();
+
+   if (mode_ == SyncMode::PerOp) {
+      // the lock is held across the sync, so records stay in sequence order
+      try {
+         writeAndSync(record);
+      } catch (std::runtime_error& e) {
+         // part of the record may be on disk: refuse further records, so none land after the torn one
+         error_ = e.what();
+         throw;
+      }
+      durable_seq_ = seq;
+      return;
+   }
+
+   pending_ += record;
+   ++pending_count_;
+   if (mode_ == SyncMode::Async) {
+      // wake an idle flusher for the first record of a batch, and again once the batch is full
+      if (pending_count_ == 1 || pending_count_ >= max_batch_) { work_cv_.notify_one(); }
+      return;
+   }
+
+   // GroupCommit: wait for the batch holding this record; records queued meanwhile share its sync
+   work_cv_.notify_one();
+   durable_cv_.wait(lock, [&]() { return durable_seq_ >= seq || !error_.empty(); });
+   if (durable_seq_ < seq) { throw std::runtime_error(error_); }
+} // append
+
+void Journal::flushLoop() {
+   std::unique_lock<std::mutex> lock(mutex_);
+
+   while (true) {
+      work_cv_.wait(lock, [&]() { return stopping_ || pending_count_ > 0; });
+      if (pending_count_ == 0) { break; } // stopping, and nothing left to write
+
+      // Async: give the batch up to max_delay to fill. GroupCommit: the callers are blocked, so write at once;
+      //    whoever arrives during this write goes in the next batch.
+      if (mode_ == SyncMode::Async) {
+         work_cv_.wait_for(lock, max_delay_, [&]() { return stopping_ || flush_requested_ || pending_count_ >= max_batch_; });
+      }
+
+      // take the whole batch, and let appenders keep queueing while it is written
+      std::string batch;
+      batch.swap(pending_);
+      uint64_t batch_seq = next_seq_ - 1;
+      pending_count_ = 0;
+      flush_requested_ = false;
+
+      lock.unlock();
+      std::string failure;
+      try {
+         writeAndSync(batch);
+      } catch (std::runtime_error& e) {
+         failure = e.what();
+      }
+      lock.lock();
+
+      if (!failure.empty()) {
+         // The batch may be partly on disk, and after a failed fdatasync() the kernel may already consider the
+         //    pages clean: nothing written from here on can be trusted to survive. Stop, and fail everything queued.
+         error_ = failure;
+         pending_.clear();
+         pending_count_ = 0;
+         durable_cv_.notify_all();
+         break;
+      }
+      durable_seq_ = batch_seq;
+      durable_cv_.notify_all();
+   }
+} // flushLoop
+
+void Journal::sync() {
+   std::unique_lock<std::mutex> lock(mutex_);
+   if (!error_.empty()) { throw std::runtime_error(error_); }
+
+   uint64_t target = next_seq_ - 1;
+   if (durable_seq_ >= target) { return; }
+
+   flush_requested_ = true;
+   work_cv_.notify_one();
+   durable_cv_.wait(lock, [&]() { return durable_seq_ >= target || !error_.empty(); });
+
+   if (durable_seq_ < target) { throw std::runtime_error(error_); }
+} // sync
+
+bool Journal::addFile(Folder& folder, File& new_file) {
+   std::string name = new_file.getName();
+   if (!folder.addFile(new_file)) { return false; }
+
+   std::string payload;
+   putU8(payload, static_cast<uint8_t>(Op::Add));
+   putString(payload, folder.getName());
+   putFile(payload, *folder.getFile(name));
+   append(std::move(payload));
+   return true;
+} // addFile
+
+bool Journal::removeFile(Folder& folder, const std::string& name) {
+   if (!folder.removeFile(name)) { return false; }
+
+   std::string payload;
+   putU8(payload, static_cast<uint8_t>(Op::Remove));
+   putString(payload, folder.getName());
+   putString(payload, name);
+   append(std::move(payload));
+   return true;
+} // removeFile
+
+bool Journal::moveFileTo(Folder& source, const std::string& name, Folder& destination) {
+   if (!source.moveFileTo(name, destination)) { return false; }
+
+   std::string payload;
+   putU8(payload, static_cast<uint8_t>(Op::Move));
+   putString(payload, source.getName());
+   putString(payload, name);
+   putString(payload, destination.getName());
+   append(std::move(payload));
+   return true;
+} // moveFileTo
+
+bool Journal::copyFileTo(Folder& source, const std::string& name, Folder& destination) {
+   if (!source.copyFileTo(name, destination)) { return false; }
+
+   std::string payload;
+   putU8(payload, static_cast<uint8_t>(Op::Copy));
+   putString(payload, source.getName());
+   putString(payload, name);
+   putString(payload, destination.getName());
+   append(std::move(payload));
+   return true;
+} // copyFileTo
+
+bool Journal::setFileContents(Folder& folder, const std::string& name, const std::string& new_contents) {
+   if (!folder.setFileContents(name, new_contents)) { return false; }
+
+   std::string payload;
+   putU8(payload, static_cast<uint8_t>(Op::SetContents));
+   putString(payload, folder.getName());
+   putString(payload, name);
+   putString(payload, new_contents);
+   append(std::move(payload));
+   return true;
+} // setFileContents
+
+size_t Journal::applyRecords(const std::string& path, size_t offset, std::map<std::string, Folder>* folders,
+                             uint64_t min_seq, uint64_t& last_seq, size_t& applied) {
+   std::ifstream file(path, std::ios::binary);
+   if (!file) { return offset; }
+   file.seekg(0, std::ios::end);
+   size_t end = static_cast<size_t>(file.tellg());
+   file.seekg(static_cast<std::streamoff>(offset));
+
+   // one record in memory at a time
+   size_t pos = offset;
+   std::string data;
+   while (end - pos >= HEADER_BYTES) {
+      data.resize(HEADER_BYTES);
+      file.read(&data[0], HEADER_BYTES);
+      Reader header { data, 0, HEADER_BYTES };
+      size_t length = header.getUnsigned(4);
+      uint32_t crc = static_cast<uint32_t>(header.getUnsigned(4));
+      if (!file || end - pos - HEADER_BYTES < length) { break; } // torn
+
+      data.resize(length);
+      file.read(&data[0], length);
+      if (!file || crc32(data.data(), length) != crc) { break; } // torn or corrupt
+
+      Reader in { data, 0, length };
+      uint64_t seq = in.getUnsigned(8);
+      Op op = static_cast<Op>(in.getUnsigned(1));
+      std::string folder = in.getString();
+      std::string name;
+      if (op != Op::Folder) { name = in.getString(); }
+
+      std::string contents;
+      std::string destination;
+      int* icon = nullptr;
+      if (op == Op::Add) {
+         contents = in.getString();
+         if (in.getUnsigned(1) != 0) {
+            icon = new int[ICON_INTS];
+            for (size_t i = 0; i < ICON_INTS; ++i) { icon[i] = static_cast<int>(in.getUnsigned(4)); }
+         }
+      } else if (op == Op::SetContents) {
+         contents = in.getString();
+      } else if (op == Op::Move || op == Op::Copy) {
+         destination = in.getString();
+      }
+
+      if (!in.ok || in.pos != in.end) {
+         // checksum matched but the payload doesn't parse: written by something else, stop here
+         delete[] icon;
+         break;
+      }
+      pos += HEADER_BYTES + length;
+
+      last_seq = std::max(last_seq, seq);
+
+      if (folders == nullptr || (seq != 0 && seq <= min_seq)) { // only validating, or already covered by the snapshot
+         delete[] icon;
+         continue;
+      }
+      ++applied;
+
+      switch (op) {
+         case Op::Add: {
+            File file(name, std::move(contents), icon);
+            folderNamed(*folders, folder).addFile(file);
+            break;
+         }
+         case Op::Remove:
+            folderNamed(*folders, folder).removeFile(name);
+            break;
+         case Op::Move:
+            folderNamed(*folders, folder).moveFileTo(name, folderNamed(*folders, destination));
+            break;
+         case Op::Copy:
+            folderNamed(*folders, folder).copyFileTo(name, folderNamed(*folders, destination));
+            break;
+         case Op::SetContents:
+            folderNamed(*folders, folder).setFileContents(name, contents);
+            break;
+         case Op::Folder:
+            folderNamed(*folders, folder);
+            break;
+      }
+   }
+
+   return pos;
+} // applyRecords
+
+size_t Journal::replay(std::map<std::string, Folder>& folders) {
+   sync(); // so records logged before the replay are read back too
+
+   size_t applied = 0;
+   uint64_t snapshot_seq = 0;
+   uint64_t last_seq = 0;
+
+   std::ifstream snapshot(snapshot_path_, std::ios::binary);
+   if (snapshot) {
+      std::string header(sizeof(SNAPSHOT_MAGIC) + 8, '\0');
+      snapshot.read(&header[0], header.size());
+      header.resize(static_cast<size_t>(snapshot.gcount()));
+      snapshot_seq = snapshotSeq(snapshot_path_, header);
+      snapshot.seekg(0, std::ios::end);
+      size_t snapshot_bytes = static_cast<size_t>(snapshot.tellg());
+
+      // a snapshot is written whole and renamed into place, so any damage means it can't be trusted: check every
+      //    record before touching folders, rather than load part of it
+      if (applyRecords(snapshot_path_, header.size(), nullptr, 0, last_seq, applied) != snapshot_bytes) {
+         throw std::runtime_error("Corrupt snapshot " + snapshot_path_);
+      }
+      applyRecords(snapshot_path_, header.size(), &folders, 0, last_seq, applied);
+   }
+
+   // the constructor already cut off any torn tail, and this instance only appends whole records
+   applyRecords(path_, 0, &folders, snapshot_seq, last_seq, applied);
+   return applied;
+} // replay
+
+void Journal::checkpoint(const std::map<std::string, Folder>& folders) {
+   sync();
+
+   std::string header(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      putU64(header, next_seq_ - 1);
+   }
+
+   // write aside, sync, then atomically swap in
+   std::string tmp_path = snapshot_path_ + ".tmp";
+   int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+   if (fd < 0) { throw std::runtime_error("Cannot create snapshot " + tmp_path + ": " + std::strerror(errno)); }
+
+   // snapshot records hold only Folder and Add operations, streamed out a folder and a file at a time
+   try {
+      SnapshotWriter writer(fd);
+      writer.write(header);
+      for (const auto& entry : folders) {
+         const Folder& folder = entry.second;
+         std::string& record = writer.beginRecord();
+         putU8(record, static_cast<uint8_t>(Op::Folder));
+         putString(record, folder.getName());
+         writer.endRecord();
+
+         for (const std::string& name : folder.getNamesWithPrefix("")) {
+            std::string& file_record = writer.beginRecord();
+            putU8(file_record, static_cast<uint8_t>(Op::Add));
+            putString(file_record, folder.getName());
+            putFile(file_record, *folder.getFile(name));
+            writer.endRecord();
+         }
+      }
+      writer.flush();
+   } catch (std::runtime_error&) {
+      ::close(fd);
+      ::unlink(tmp_path.c_str());
+      throw;
+   }
+
+   if (::fsync(fd) != 0 || ::close(fd) != 0 || ::rename(tmp_path.c_str(), snapshot_path_.c_str()) != 0) {
+      throw std::runtime_error("Snapshot commit failed: " + std::string(std::strerror(errno)));
+   }
+
+   std::string dir = path_.find('/') == std::string::npos ? "." : path_.substr(0, path_.rfind('/') + 1);
+   int dir_fd = ::open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+   if (dir_fd >= 0) {
+      ::fsync(dir_fd);
+      ::close(dir_fd);
+   }
+
+   // the snapshot now covers everything in the journal
+   std::lock_guard<std::mutex> lock(mutex_);
+   if (::ftruncate(fd_, 0) != 0 || ::fsync(fd_) != 0) {
+      throw std::runtime_error("Cannot truncate journal " + path_ + ": " + std::strerror(errno));
+   }
+   journal_bytes_ = 0;
+} // checkpoint
+
+bool Journal::checkpointDue() {
+   std::lock_guard<std::mutex> lock(mutex_);
+   return journal_bytes_ >= checkpoint_bytes_;
+} // checkpointDue
@@ -0,0 +1,168 @@
+#pragma once
+#include "File.hpp"
+#include "Folder.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @brief An append-only journal of Folder mutations, with checksummed records, group commit, replay and snapshots.
+ *
+ * Mutations go through the Journal instead of directly through Folder: each one is applied to the Folder and,
+ *    if it succeeded, appended to the journal file as a record of
+ *    [u32 payload length][u32 CRC-32 of payload][payload], where the payload starts with a u64 sequence number.
+ *
+ * In SyncMode::PerOp every mutation is written and fdatasync()ed by the calling thread before it returns.
+ * In SyncMode::GroupCommit every mutation is also durable before it returns, but a background thread does the
+ *    writing: callers queue their record and block, and all records queued while one sync is in progress go
+ *    out together in the next, so concurrent callers share one write and one fdatasync().
+ * In SyncMode::Async mutations return as soon as they are queued. The background thread writes a batch once
+ *    max_batch records are waiting or max_delay has passed, so a mutation is durable once sync() returns, or
+ *    about max_delay after it was made. A crash can lose the last unsynced batch.
+ *
+ * checkpoint() compacts the journal: it writes every folder to a snapshot file and empties the journal.
+ *    Snapshots and journals are written and read a record at a time, so neither has to fit in memory at once.
+ * replay() restores state on startup by loading the snapshot and then the journal records newer than it.
+ * The constructor cuts off a torn or corrupt tail and continues numbering after the last good record,
+ *    so mutations can be logged before or after replay() without reusing sequence numbers.
+ *
+ * Records name folders by getName(), so folder names should be unique.
+ * The Journal is safe to call from several threads, as long as no two threads touch the same Folder at once.
+ */
+class Journal {
+   public:
+      enum class SyncMode { PerOp, GroupCommit, Async };
+
+   private:
+      enum class Op : uint8_t { Add = 1, Remove, Move, Copy, SetContents, Folder };
+
+      std::string path_;
+      std::string snapshot_path_;
+      SyncMode mode_;
+      size_t max_batch_;
+      std::chrono::microseconds max_delay_;
+      size_t checkpoint_bytes_;
+      int fd_ = -1;
+
+      std::mutex mutex_;
+      std::condition_variable work_cv_;    // wakes the flusher
+      std::condition_variable durable_cv_; // wakes threads waiting for their records to be synced
+      std::string pending_;                // serialized records not yet written
+      size_t pending_count_ = 0;
+      uint64_t next_seq_ = 1;
+      uint64_t durable_seq_ = 0;           // every record up to this one has been synced
+      size_t journal_bytes_ = 0;
+      bool flush_requested_ = false;
+      bool stopping_ = false;
+      std::string error_;                  // first failed write or sync; every later call rethrows it
+      std::thread flusher_;
+
+      /**
+       * @brief Stamps a sequence number on the payload and writes the record according to the SyncMode
+       * @throws std::runtime_error If this or an earlier write or sync failed
+       */
+      void append(std::string payload);
+
+      /**
+       * @brief Reads the snapshot header and validates the journal, cutting off a torn tail, to find where
+       *    sequence numbers continue
+       * @throws std::runtime_error If the snapshot header is bad or the journal cannot be truncated
+       */
+      void recover();
+
+      /**
+       * @brief Writes data to the journal file and fdatasync()s it
+       * @throws std::runtime_error If the write or sync fails
+       */
+      void writeAndSync(const std::string& data);
+
+      /**
+       * @brief Body of the group commit thread
+       */
+      void flushLoop();
+
+      /**
+       * @brief Streams the records of the file at path, starting at offset, into folders, skipping those with a
+       *    sequence number <= min_seq. With folders == nullptr the records are only validated.
+       *
+       * @return size_t The offset just past the last valid record (the rest of the file is torn or corrupt)
+       */
+      size_t applyRecords(const std::string& path, size_t offset, std::map<std::string, Folder>* folders,
+                          uint64_t min_seq, uint64_t& last_seq, size_t& applied);
+
+   public:
+      /**
+       * @brief Opens (creating if necessary) the journal at path. The snapshot lives next to it at path + ".snapshot".
+       *
+       * @param path The path of the journal file
+       * @param mode Whether to sync after every mutation, in shared batches, or in the background
+       * @param max_batch Async only: flush as soon as this many records are waiting
+       * @param max_delay Async only: flush at most this long after the oldest waiting record was made
+       * @param checkpoint_bytes checkpointDue() turns true once the journal grows past this many bytes
+       * @throws std::runtime_error If the journal file cannot be opened or truncated, or the snapshot header is bad
+       */
+      Journal(const std::string& path, SyncMode mode = SyncMode::GroupCommit, size_t max_batch = 512,
+              std::chrono::microseconds max_delay = std::chrono::milliseconds(2), size_t checkpoint_bytes = 64 << 20);
+
+      /**
+       * @brief (DESTRUCTOR) Makes every logged mutation durable, then closes the journal
+       */
+      ~Journal();
+
+      Journal(const Journal&) = delete;
+      Journal& operator=(const Journal&) = delete;
+
+      /**
+       * @brief Logged versions of the Folder mutations. Each behaves exactly like its Folder counterpart,
+       *    and is journaled only if it succeeded.
+       * @throws std::runtime_error If the record could not be made durable. The Folder has already been changed
+       *    by then, but the change may be lost on replay. A failed write leaves the journal unusable: every later
+       *    call throws too.
+       */
+      bool addFile(Folder& folder, File& new_file);
+      bool removeFile(Folder& folder, const std::string& name);
+      bool moveFileTo(Folder& source, const std::string& name, Folder& destination);
+      bool copyFileTo(Folder& source, const std::string& name, Folder& destination);
+      bool setFileContents(Folder& folder, const std::string& name, const std::string& new_contents);
+
+      /**
+       * @brief Blocks until every mutation logged so far is durable
+       * @throws std::runtime_error If a write or sync of the journal failed
+       */
+      void sync();
+
+      /**
+       * @brief Rebuilds state from the snapshot and the journal, including anything logged through this Journal so far.
+       * Folders named in the records are created in folders if missing. Must not run concurrently with logged mutations.
+       *
+       * @param folders The folders to replay into, keyed by folder name
+       * @return size_t The number of snapshot and journal records applied
+       * @throws std::runtime_error If the snapshot is damaged. Nothing is applied in that case.
+       */
+      size_t replay(std::map<std::string, Folder>& folders);
+
+      /**
+       * @brief Writes every folder to a new snapshot (atomically replacing the old one) and empties the journal.
+       * Must not run concurrently with logged mutations.
+       *
+       * @param folders The complete current state, keyed by folder name
+       * @throws std::runtime_error If the snapshot cannot be written
+       */
+      void checkpoint(const std::map<std::string, Folder>& folders);
+
+      /**
+       * @brief Returns true once the journal has grown past checkpoint_bytes since the last checkpoint
+       */
+      bool checkpointDue();
+
+      /**
+       * @brief Computes the CRC-32 (IEEE 802.3 polynomial) of the given bytes
+       */
+      static uint32_t crc32(const char* data, size_t size);
+};
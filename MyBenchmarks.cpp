@@ -0,0 +1,298 @@
+// Build separately from MyTests.cpp (both define main):
+//    g++ -std=c++17 -O2 -pthread File.cpp Folder.cpp Importer.cpp ContentIndex.cpp Journal.cpp ContentCache.cpp FileBTree.cpp FileStore.cpp MyBenchmarks.cpp -o bench
+#include "File.hpp"
+#include "Folder.hpp"
+#include "InvalidFormatException.hpp"
+#include "Journal.hpp"
+#include "FileStore.hpp"
+#include "Importer.hpp"
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <filesystem>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Runs fn once and returns the elapsed wall time in milliseconds
+template <typename Fn>
+double timeMs(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void benchQueries(size_t n_files) {
+    std::cout << "========< QUERY BENCHMARK (" << n_files << " files) >========" << std::endl;
+
+    // 1% .log, 9% .csv, 90% .txt; names f0000000 ... in sorted order
+    Folder folder("Bench");
+    std::vector<File> batch;
+    batch.reserve(n_files);
+    for (size_t i = 0; i < n_files; ++i) {
+        std::string id = std::to_string(i);
+        std::string name = "f" + std::string(7 - std::min<size_t>(7, id.size()), '0') + id;
+        const char* ext = (i % 100 == 0) ? ".log" : (i % 10 == 0) ? ".csv" : ".txt";
+        batch.emplace_back(name + ext);
+    }
+    double load_ms = timeMs([&]() { folder.addFiles(batch); });
+    std::cout << "addFiles (bulk load): " << load_ms << " ms" << std::endl;
+
+    size_t hits = 0;
+    const int reps = 1000;
+    double ms = timeMs([&]() { for (int r = 0; r < reps; ++r) { hits += folder.getNamesWithPrefix("f00123").size(); } });
+    std::cout << "prefix, selective   (" << hits / reps << " hits): " << ms / reps << " ms/query" << std::endl;
+
+    hits = 0;
+    ms = timeMs([&]() { for (int r = 0; r < reps; ++r) { hits += folder.getNamesInRange("f0050000", "f0050100").size(); } });
+    std::cout << "range,  selective   (" << hits / reps << " hits): " << ms / reps << " ms/query" << std::endl;
+
+    hits = 0;
+    ms = timeMs([&]() { for (int r = 0; r < reps; ++r) { hits += folder.getNamesWithExtension("log").size(); } });
+    std::cout << "ext,    selective   (" << hits / reps << " hits): " << ms / reps << " ms/query" << std::endl;
+
+    hits = 0;
+    ms = timeMs([&]() { hits += folder.getNamesWithPrefix("f0").size(); });
+    std::cout << "prefix, broad       (" << hits << " hits): " << ms << " ms/query" << std::endl;
+
+    hits = 0;
+    ms = timeMs([&]() { hits += folder.getNamesWithExtension("txt").size(); });
+    std::cout << "ext,    broad       (" << hits << " hits): " << ms << " ms/query" << std::endl;
+}
+
+void benchContentSearch(size_t n_files, size_t file_bytes) {
+    std::cout << "========< CONTENT SEARCH BENCHMARK (" << n_files << " x " << file_bytes << " bytes) >========" << std::endl;
+
+    // random words from a 50K-word vocabulary of 4-9 letter pseudo-words, with a rare word planted in 0.1% of the files
+    std::mt19937 rng(42);
+    std::vector<std::string> vocabulary;
+    for (int w = 0; w < 50000; ++w) {
+        std::string word(4 + rng() % 6, 'a');
+        for (char& ch : word) { ch = static_cast<char>('a' + rng() % 26); }
+        vocabulary.push_back(word);
+    }
+    std::uniform_int_distribution<size_t> word_id(0, vocabulary.size() - 1);
+    std::vector<File> batch;
+    batch.reserve(n_files);
+    for (size_t i = 0; i < n_files; ++i) {
+        std::string body;
+        body.reserve(file_bytes + 16);
+        if (i % 1000 == 0) { body += "needlephrase "; }
+        while (body.size() < file_bytes) { body += vocabulary[word_id(rng)] + " "; }
+        batch.emplace_back("doc" + std::to_string(i), std::move(body));
+    }
+
+    Folder indexed("Indexed");
+    Folder scanned("Scanned");
+    std::vector<File> copies(batch);
+    indexed.addFiles(batch);
+    scanned.addFiles(copies);
+
+    double build_ms = timeMs([&]() { indexed.enableContentIndex(); });
+    std::cout << "index build: " << build_ms << " ms, " << (indexed.getContentIndexBytes() >> 20) << " MiB for "
+              << (n_files * file_bytes >> 20) << " MiB of text" << std::endl;
+
+    std::string queries[] = { "needlephrase", vocabulary[123], vocabulary[123].substr(0, 3), "ab" };
+    for (const std::string& q : queries) {
+        size_t hits = 0;
+        double idx_ms = timeMs([&]() { hits = indexed.searchContents(q).size(); });
+        double scan_ms = timeMs([&]() { scanned.searchContents(q); });
+        std::cout << "\"" << q << "\" (" << hits << " hits): indexed " << idx_ms << " ms, scan " << scan_ms << " ms" << std::endl;
+    }
+
+    double update_ms = timeMs([&]() {
+        for (size_t i = 0; i < 1000; ++i) { indexed.setFileContents("doc" + std::to_string(i) + ".txt", "replaced body " + vocabulary[7]); }
+    });
+    std::cout << "setFileContents (indexed): " << update_ms / 1000 << " ms/op" << std::endl;
+}
+
+// Each thread churns its own folder: add a 256-byte file, rewrite it, remove every other one
+double journalOpsPerSecond(Journal::SyncMode mode, size_t n_threads, size_t ops_per_thread) {
+    std::string path = (std::filesystem::temp_directory_path() / "MyBenchmarksJournal.log").string();
+    std::filesystem::remove(path);
+
+    double ms;
+    {
+        Journal journal(path, mode);
+        std::vector<Folder> folders;
+        for (size_t t = 0; t < n_threads; ++t) { folders.emplace_back("T" + std::to_string(t)); }
+
+        ms = timeMs([&]() {
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < n_threads; ++t) {
+                threads.emplace_back([&, t]() {
+                    for (size_t i = 0; i < ops_per_thread / 3; ++i) {
+                        std::string name = "f" + std::to_string(i);
+                        File file(name, std::string(256, 'x'));
+                        journal.addFile(folders[t], file);
+                        journal.setFileContents(folders[t], name + ".txt", std::string(256, 'y'));
+                        journal.removeFile(folders[t], (i % 2 ? name : "f" + std::to_string(i / 2)) + ".txt");
+                    }
+                });
+            }
+            for (auto& th : threads) { th.join(); }
+            journal.sync();
+        });
+    }
+
+    std::filesystem::remove(path);
+    return n_threads * (ops_per_thread / 3) * 3 / (ms / 1000.0);
+}
+
+void benchJournal() {
+    std::cout << "========< JOURNAL BENCHMARK >========" << std::endl;
+    // PerOp and GroupCommit are durable when each call returns; Async only after sync() at the end of the run
+    for (size_t n_threads : { 1, 4, 16 }) {
+        double per_op = journalOpsPerSecond(Journal::SyncMode::PerOp, n_threads, 3000);
+        double group = journalOpsPerSecond(Journal::SyncMode::GroupCommit, n_threads, 3000);
+        double async = journalOpsPerSecond(Journal::SyncMode::Async, n_threads, 300000);
+        std::cout << n_threads << " thread(s): sync-per-op " << per_op << " ops/s, group commit " << group
+                  << " ops/s, async " << async << " ops/s" << std::endl;
+    }
+}
+
+// Lazy files over a data file 10x the cache budget, read uniformly and with a skewed (90/10) pattern
+void benchLazyContents(size_t budget_bytes, size_t file_bytes) {
+    std::cout << "========< LAZY CONTENTS BENCHMARK (budget " << (budget_bytes >> 20) << " MiB, data "
+              << (10 * budget_bytes >> 20) << " MiB) >========" << std::endl;
+
+    std::string path = (std::filesystem::temp_directory_path() / "MyBenchmarksLazy.dat").string();
+    size_t n_files = 10 * budget_bytes / file_bytes;
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::string block(file_bytes, 'x');
+        for (size_t i = 0; i < n_files; ++i) { out << block; }
+    }
+
+    Folder folder("Lazy");
+    std::vector<File> batch;
+    for (size_t i = 0; i < n_files; ++i) {
+        batch.emplace_back("f" + std::to_string(i), ContentSource{path, i * file_bytes, file_bytes});
+    }
+    folder.addFiles(batch);
+
+    ContentCache& cache = ContentCache::instance();
+    cache.setBudget(budget_bytes);
+
+    double ms = timeMs([&]() { folder.getSize(); });
+    std::cout << "Folder::getSize over " << n_files << " lazy files: " << ms << " ms, "
+              << cache.getStats().misses << " loads" << std::endl;
+
+    std::mt19937 rng(7);
+    const size_t reads = 20000;
+    for (bool skewed : { false, true }) {
+        cache.clear();
+        cache.resetStats();
+        size_t hot = n_files / 10; // skewed: 90% of reads go to 10% of the files
+        ms = timeMs([&]() {
+            for (size_t r = 0; r < reads; ++r) {
+                size_t i = (skewed && rng() % 10 != 0) ? rng() % hot : rng() % n_files;
+                folder.getFile("f" + std::to_string(i) + ".txt")->getContents(0, 16);
+            }
+        });
+        CacheStats stats = cache.getStats();
+        std::cout << (skewed ? "skewed:  " : "uniform: ") << ms * 1000 / reads << " us/read, "
+                  << stats.hits << " hits, " << stats.misses << " misses, " << stats.evictions << " evictions, "
+                  << "hit rate " << 100.0 * stats.hits / reads << "%" << std::endl;
+    }
+
+    cache.clear();
+    std::filesystem::remove(path);
+}
+
+// Drops a file's pages from the page cache, so the next read has to go to the device
+void evictFromCache(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { return; }
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+// Imports a tree of n_dirs x files_per_dir files with a cold and then a warm page cache, for several worker counts
+void benchImport(size_t n_dirs, size_t files_per_dir, size_t file_bytes) {
+    std::cout << "========< IMPORT BENCHMARK (" << n_dirs * files_per_dir << " x " << (file_bytes >> 10) << " KiB) >========" << std::endl;
+
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / "MyBenchmarksImport";
+    fs::remove_all(root);
+    std::vector<std::string> paths;
+    std::string body(file_bytes, 'x');
+    for (size_t d = 0; d < n_dirs; ++d) {
+        fs::path dir = root / ("dir" + std::to_string(d));
+        fs::create_directories(dir);
+        for (size_t f = 0; f < files_per_dir; ++f) {
+            paths.push_back((dir / ("f" + std::to_string(f) + ".txt")).string());
+            std::ofstream(paths.back(), std::ios::binary) << body;
+        }
+    }
+
+    for (size_t n_threads : { 1, 2, 4, 8, 16, 32, 64 }) {
+        for (const std::string& path : paths) { evictFromCache(path); }
+        Importer importer(n_threads);
+        importer.importDirectory(root.string());
+        ImportStats cold = importer.getStats();
+        importer.importDirectory(root.string());
+        ImportStats warm = importer.getStats();
+        std::cout << n_threads << " worker(s): cold " << cold.filesPerSecond() << " files/s, " << cold.megabytesPerSecond()
+                  << " MB/s; warm " << warm.filesPerSecond() << " files/s, " << warm.megabytesPerSecond() << " MB/s" << std::endl;
+    }
+    std::cout << "default (" << Importer().getNumThreads() << " workers)" << std::endl;
+
+    fs::remove_all(root);
+}
+
+// Fixed-width names so string order matches numeric order
+std::string benchName(size_t i) {
+    std::string id = std::to_string(i);
+    return "f" + std::string(9 - std::min<size_t>(9, id.size()), '0') + id + ".txt";
+}
+
+// Prefills a store with n_files odd-numbered names, then times random inserts (even names), erases and a full scan
+void benchStore(StorageBackend backend, size_t n_files, size_t ops) {
+    FileStore store(backend);
+    {
+        std::vector<File> batch;
+        batch.reserve(n_files);
+        for (size_t i = 0; i < n_files; ++i) { batch.emplace_back(benchName(2 * i + 1)); }
+        store.insertSorted(batch);
+    }
+
+    std::mt19937 rng(31);
+    std::vector<File> to_insert;
+    std::vector<std::string> to_erase;
+    for (size_t i = 0; i < ops; ++i) {
+        to_insert.emplace_back(benchName(2 * (rng() % n_files)));
+        to_erase.push_back(benchName(2 * (rng() % n_files) + 1));
+    }
+
+    double insert_ms = timeMs([&]() { for (File& file : to_insert) { store.insert(std::move(file)); } });
+    double erase_ms = timeMs([&]() { for (const std::string& name : to_erase) { store.erase(name); } });
+    size_t visited = 0;
+    double scan_ms = timeMs([&]() { store.forEach([&visited](const File& file) { visited += file.getSize() + 1; return true; }); });
+
+    std::cout << (backend == StorageBackend::BTree ? "btree " : "vector") << " n=" << n_files
+              << ": insert " << ops / (insert_ms / 1000.0) << " ops/s, erase " << ops / (erase_ms / 1000.0)
+              << " ops/s, iterate " << visited / (scan_ms / 1000.0) << " files/s" << std::endl;
+}
+
+void benchBackends() {
+    std::cout << "========< STORAGE BACKEND BENCHMARK >========" << std::endl;
+    for (size_t n_files : { 1000, 100000, 10000000 }) {
+        size_t ops = n_files >= 10000000 ? 200 : 5000;
+        benchStore(StorageBackend::Vector, n_files, ops);
+        benchStore(StorageBackend::BTree, n_files, ops);
+    }
+}
+
+int main () {
+    benchQueries(1000000);
+    benchContentSearch(50000, 2048);
+    benchJournal();
+    benchImport(16, 1024, 64 << 10);
+    benchLazyContents(16 << 20, 64 << 10);
+    benchBackends();
+}
@@ -1,9 +1,16 @@
 #include "File.hpp"
 #include "Folder.hpp"
 #include "InvalidFormatException.hpp"
+#include "Importer.hpp"
+#include "Journal.hpp"
 #include <iostream>
 #include <cassert>
 #include <vector>
+#include <fstream>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <random>
 
 int main () {
     std::cout << "========< EMPTY CONSTRUCTOR TEST >========" << std::endl;
@@ -157,4 +164,399 @@ int main () {
     std::cout << myFolder.removeFile("e.txt") << std::endl; //e.txt still valid in otherFolder, deep copied
     myFolder.display();
     otherFolder.display();
+
+    std::cout << "===========< BULK ADD TESTING >===========" << std::endl;
+    Folder bulkFolder("Bulk");
+    File existing ("m", "old");
+    bulkFolder.addFile(existing);
+    std::vector<File> batch;
+    batch.emplace_back("z");
+    batch.emplace_back("m", "new"); //duplicate of existing, skipped
+    batch.emplace_back("a");
+    batch.emplace_back("a"); //duplicate within batch, skipped
+    assert(bulkFolder.addFiles(batch) == 2);
+    assert(batch.empty());
+    assert(bulkFolder.removeFile("a.txt")); //binary search relies on sorted order
+    assert(bulkFolder.removeFile("m.txt"));
+    assert(bulkFolder.removeFile("z.txt"));
+    assert(!bulkFolder.removeFile("m.txt"));
+
+    std::cout << "===========< QUERY TESTING >===========" << std::endl;
+    Folder queryFolder("Queries");
+    std::vector<File> reports;
+    reports.emplace_back("report2023.log");
+    reports.emplace_back("report2024.log");
+    reports.emplace_back("report2024b.txt");
+    reports.emplace_back("report2025.log");
+    reports.emplace_back("readme");
+    reports.emplace_back("zeta.log");
+    queryFolder.addFiles(reports);
+    assert((queryFolder.getNamesWithPrefix("report2024") == std::vector<std::string>{"report2024.log", "report2024b.txt"}));
+    assert(queryFolder.getNamesWithPrefix("").size() == 6);
+    assert(queryFolder.getNamesWithPrefix("x").empty());
+    assert((queryFolder.getNamesInRange("report2024", "report2025") == std::vector<std::string>{"report2024.log", "report2024b.txt"}));
+    assert(queryFolder.getNamesInRange("z", "a").empty());
+    assert((queryFolder.getNamesWithExtension(".log") == std::vector<std::string>{"report2023.log", "report2024.log", "report2025.log", "zeta.log"}));
+    assert((queryFolder.getNamesWithExtension("txt") == std::vector<std::string>{"readme.txt", "report2024b.txt"}));
+
+    // the extension index follows files around
+    queryFolder.removeFile("zeta.log");
+    queryFolder.moveFileTo("report2023.log", bulkFolder);
+    queryFolder.copyFileTo("report2025.log", bulkFolder);
+    assert((queryFolder.getNamesWithExtension("log") == std::vector<std::string>{"report2024.log", "report2025.log"}));
+    assert((bulkFolder.getNamesWithExtension("log") == std::vector<std::string>{"report2023.log", "report2025.log"}));
+    assert((bulkFolder.getNamesWithPrefix("report") == std::vector<std::string>{"report2023.log", "report2025.log"}));
+    assert(queryFolder.getNamesWithExtension("md").empty());
+
+    std::cout << "===========< CONTENT SEARCH TESTING >===========" << std::endl;
+    Folder docs("Docs");
+    Folder archive("Archive");
+    File doc1 ("one", "the quick brown fox");
+    File doc2 ("two", "foxes are quick");
+    File doc3 ("three", "nothing to see");
+    docs.addFile(doc1);
+    docs.addFile(doc2);
+    assert((docs.searchContents("quick") == std::vector<std::string>{"one.txt", "two.txt"})); //unindexed scan
+    docs.enableContentIndex();
+    assert(docs.hasContentIndex());
+    docs.addFile(doc3);
+    assert((docs.searchContents("quick") == std::vector<std::string>{"one.txt", "two.txt"}));
+    assert((docs.searchContents("fox") == std::vector<std::string>{"one.txt", "two.txt"}));
+    assert((docs.searchTerm("fox") == std::vector<std::string>{"one.txt"}));
+    assert((docs.searchContents("to") == std::vector<std::string>{"three.txt"})); //shorter than a trigram
+    assert(docs.searchContents("quack").empty());
+
+    assert(docs.setFileContents("three.txt", "quick now"));
+    assert(!docs.setFileContents("four.txt", "quick"));
+    assert((docs.searchTerm("quick") == std::vector<std::string>{"one.txt", "three.txt", "two.txt"}));
+    assert(docs.searchContents("nothing").empty());
+
+    archive.enableContentIndex();
+    docs.moveFileTo("one.txt", archive);
+    docs.copyFileTo("two.txt", archive);
+    docs.removeFile("three.txt");
+    assert((docs.searchContents("quick") == std::vector<std::string>{"two.txt"}));
+    assert((archive.searchContents("quick") == std::vector<std::string>{"one.txt", "two.txt"}));
+    assert(docs.getContentIndexBytes() > 0);
+    docs.disableContentIndex();
+    assert(docs.getContentIndexBytes() == 0);
+    assert((docs.searchContents("quick") == std::vector<std::string>{"two.txt"}));
+
+    // enough churn to make the index purge its tombstones
+    Folder churn("Churn");
+    churn.enableContentIndex();
+    for (int i = 0; i < 3000; ++i) {
+        File tmp ("c" + std::to_string(i), "payload" + std::to_string(i % 7));
+        churn.addFile(tmp);
+        if (i % 3 != 0) { churn.removeFile("c" + std::to_string(i) + ".txt"); }
+    }
+    assert(churn.searchContents("payload").size() == 1000);
+    assert(churn.searchContents("payload3").size() == 143);
+    File far ("far", "payload3 zzfarzz"); //ids far apart -> multi-byte gaps in the posting lists
+    churn.addFile(far);
+    assert((churn.searchContents("zzfarzz") == std::vector<std::string>{"far.txt"}));
+    assert(churn.searchContents("payload3").size() == 144);
+
+    std::cout << "===========< JOURNAL TESTING >===========" << std::endl;
+    namespace fs = std::filesystem;
+    std::string journalPath = (fs::temp_directory_path() / "MyTestsJournal.log").string();
+    fs::remove(journalPath);
+    fs::remove(journalPath + ".snapshot");
+    {
+        std::map<std::string, Folder> state;
+        Journal journal(journalPath, Journal::SyncMode::GroupCommit);
+        assert(journal.replay(state) == 0);
+        Folder& home = state.try_emplace("Home", "Home").first->second;
+        Folder& work = state.try_emplace("Work", "Work").first->second;
+
+        int* icon = new int[256];
+        std::fill(icon, icon + 256, 7);
+        File j1 ("notes", "first draft", icon);
+        File j2 ("todo.md", "buy milk");
+        File dupe ("todo.md", "dupe");
+        assert(journal.addFile(home, j1));
+        assert(journal.addFile(home, j2));
+        assert(!journal.addFile(home, dupe)); //failed mutations aren't journaled
+        assert(journal.setFileContents(home, "notes.txt", "second draft"));
+        assert(journal.copyFileTo(home, "todo.md", work));
+        assert(journal.moveFileTo(home, "notes.txt", work));
+        assert(journal.removeFile(home, "todo.md"));
+        journal.sync();
+    }
+    {
+        std::map<std::string, Folder> state;
+        Journal journal(journalPath, Journal::SyncMode::PerOp);
+        assert(journal.replay(state) == 6);
+        assert(state.at("Home").getNamesWithPrefix("").empty());
+        assert((state.at("Work").getNamesWithPrefix("") == std::vector<std::string>{"notes.txt", "todo.md"}));
+        assert(state.at("Work").getFile("notes.txt")->getContents() == "second draft");
+        assert(state.at("Work").getFile("notes.txt")->getIcon()[255] == 7);
+
+        journal.checkpoint(state);
+        assert(fs::file_size(journalPath) == 0);
+        File j3 ("later");
+        assert(journal.addFile(state.at("Home"), j3));
+    }
+    {
+        // tear the last record in half, as a crash mid-write would
+        fs::resize_file(journalPath, fs::file_size(journalPath) - 3);
+        Journal journal(journalPath, Journal::SyncMode::Async);
+        assert(fs::file_size(journalPath) == 0); //torn tail cut off on open
+
+        // logged before replay: must be numbered after the snapshot, or replay would skip it
+        std::map<std::string, Folder> state;
+        File j4 ("early");
+        assert(journal.addFile(state.try_emplace("Home", "Home").first->second, j4));
+        assert(journal.replay(state) == 5); //snapshot: 2 folders + 2 files, journal: 1 file
+        assert(state.at("Home").getFile("later.txt") == nullptr);
+    }
+    {
+        std::map<std::string, Folder> state;
+        Journal journal(journalPath);
+        assert(journal.replay(state) == 5);
+        assert(state.at("Home").getFile("early.txt") != nullptr);
+    }
+    {
+        // a damaged snapshot is refused whole
+        std::fstream snapshot(journalPath + ".snapshot", std::ios::binary | std::ios::in | std::ios::out);
+        snapshot.seekp(-1, std::ios::end);
+        snapshot.put('!');
+    }
+    {
+        std::map<std::string, Folder> state;
+        Journal journal(journalPath);
+        bool threw = false;
+        try {
+            journal.replay(state);
+        } catch (std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw && state.empty());
+    }
+    {
+        std::fstream snapshot(journalPath + ".snapshot", std::ios::binary | std::ios::in | std::ios::out);
+        snapshot.put('X');
+    }
+    {
+        bool threw = false;
+        try {
+            Journal journal(journalPath);
+        } catch (std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw); //bad magic
+    }
+    fs::remove(journalPath);
+    fs::remove(journalPath + ".snapshot");
+
+    if (fs::exists("/dev/full")) {
+        // every write fails with ENOSPC: the failure is reported, the Folder keeps the change, and the journal stays failed
+        for (Journal::SyncMode mode : { Journal::SyncMode::PerOp, Journal::SyncMode::GroupCommit, Journal::SyncMode::Async }) {
+            Journal journal("/dev/full", mode);
+            Folder full("Full");
+            File f1 ("f1");
+            File f2 ("f2");
+            bool threw = false;
+            try {
+                journal.addFile(full, f1);
+                journal.sync(); //Async only reports the failure here
+            } catch (std::runtime_error&) {
+                threw = true;
+            }
+            assert(threw && full.getFile("f1.txt") != nullptr);
+            threw = false;
+            try {
+                journal.addFile(full, f2);
+            } catch (std::runtime_error&) {
+                threw = true;
+            }
+            assert(threw);
+        }
+    }
+
+    std::cout << "===========< LAZY CONTENTS TESTING >===========" << std::endl;
+    std::string dataPath = (fs::temp_directory_path() / "MyTestsLazy.dat").string();
+    std::ofstream(dataPath, std::ios::binary) << "alphabravocharlie";
+    ContentCache& cache = ContentCache::instance();
+    cache.clear();
+    cache.resetStats();
+    cache.setBudget(10);
+
+    File lazyA ("a", ContentSource{dataPath, 0, 5});
+    File lazyB ("b", ContentSource{dataPath, 5, 5});
+    File lazyC ("c", ContentSource{dataPath, 10, 7});
+    assert(lazyA.isLazy());
+    assert(lazyA.getName() == "a.txt");
+    assert(lazyC.getSize() == 7);
+    assert(cache.getStats().misses == 0); //name and size don't load anything
+
+    assert(lazyA.getContents() == "alpha");
+    assert(lazyA.getContents(1, 3) == "lph");
+    assert(lazyA.getContents(9, 3) == "");
+    assert(cache.getStats().misses == 1);
+    assert(cache.getStats().hits == 2);
+    assert(lazyB.contains("bravo", true));
+    assert(lazyC.getContents() == "charlie"); //5 + 5 + 7 > 10, evicts alpha then bravo
+    assert(cache.getStats().evictions == 2);
+    assert(cache.getStats().resident_bytes == 7);
+    assert(lazyA.getContents() == "alpha"); //reloaded
+    assert(cache.getStats().misses == 4);
+
+    File lazyCopy (lazyA); //copies share the cached body
+    assert(lazyCopy.getContents() == "alpha");
+    assert(cache.getStats().misses == 4);
+
+    Folder lazyFolder("Lazy");
+    lazyFolder.addFile(lazyB);
+    lazyFolder.addFile(lazyC);
+    assert(lazyFolder.getSize() == 12);
+    assert(lazyFolder.setFileContents("b.txt", "resident"));
+    assert(!lazyFolder.getFile("b.txt")->isLazy());
+    assert(lazyFolder.getFile("b.txt")->getContents() == "resident");
+    assert(lazyFolder.getSize() == 15);
+
+    File missing ("m", ContentSource{dataPath, 100, 5});
+    try {
+        missing.getContents();
+        assert(false);
+    } catch (std::runtime_error&) {}
+
+    // a lazy file whose data can't be read: indexing it fails, and every mutation that needs to index it rolls back
+    Folder plain("Plain");
+    Folder indexedLazy("IndexedLazy");
+    indexedLazy.enableContentIndex();
+    File broken ("x", ContentSource{dataPath + ".gone", 0, 5});
+    assert(plain.addFile(broken));
+    auto throws = [](auto fn) {
+        try {
+            fn();
+        } catch (std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    assert(throws([&]() { plain.moveFileTo("x.txt", indexedLazy); }));
+    assert(plain.getFile("x.txt") != nullptr); //still in the source
+    assert(indexedLazy.getFile("x.txt") == nullptr);
+    assert(plain.getNamesWithExtension("txt").size() == 1);
+    assert(indexedLazy.getNamesWithExtension("txt").empty());
+
+    assert(throws([&]() { plain.copyFileTo("x.txt", indexedLazy); }));
+    assert(indexedLazy.getFile("x.txt") == nullptr && indexedLazy.getNamesWithExtension("txt").empty());
+
+    File broken2 (*plain.getFile("x.txt"));
+    assert(throws([&]() { indexedLazy.addFile(broken2); }));
+    assert(indexedLazy.getNamesWithExtension("txt").empty());
+    assert(broken2.getName() == "x.txt"); //not moved from
+
+    std::vector<File> lazyBatch;
+    lazyBatch.emplace_back("ok", "readable");
+    lazyBatch.emplace_back(broken2);
+    assert(throws([&]() { indexedLazy.addFiles(lazyBatch); }));
+    assert(indexedLazy.getSize() == 0 && indexedLazy.getNamesWithExtension("txt").empty());
+    assert(indexedLazy.searchContents("readable").empty());
+    assert(lazyBatch.size() == 2 && lazyBatch[0].getName() == "ok.txt"); //handed back
+
+    assert(throws([&]() { plain.enableContentIndex(); }));
+    assert(!plain.hasContentIndex());
+
+    cache.clear();
+    cache.setBudget(256u << 20);
+    fs::remove(dataPath);
+
+    std::cout << "===========< B-TREE BACKEND TESTING >===========" << std::endl;
+    Folder treeFolder("Tree", StorageBackend::BTree);
+    Folder vectorFolder("Vector");
+    assert(treeFolder.getBackend() == StorageBackend::BTree);
+    assert(vectorFolder.getBackend() == StorageBackend::Vector);
+
+    // random churn, checked against std::set after every step; enough files to split and merge inner nodes
+    std::set<std::string> expected;
+    std::mt19937 rng(335);
+    for (int i = 0; i < 40000; ++i) {
+        std::string name = "n" + std::to_string(rng() % 5000);
+        if (rng() % 3 != 0) {
+            File tmp (name, "x");
+            bool added = expected.insert(name + ".txt").second;
+            assert(treeFolder.addFile(tmp) == added);
+        } else {
+            bool removed = expected.erase(name + ".txt") == 1;
+            assert(treeFolder.removeFile(name + ".txt") == removed);
+        }
+        if (i % 4000 == 0) {
+            assert((treeFolder.getNamesWithPrefix("") == std::vector<std::string>(expected.begin(), expected.end())));
+        }
+    }
+    assert((treeFolder.getNamesWithPrefix("") == std::vector<std::string>(expected.begin(), expected.end())));
+    assert(treeFolder.getSize() == expected.size());
+    for (const std::string& name : std::vector<std::string>(expected.begin(), expected.end())) {
+        assert(treeFolder.removeFile(name));
+    }
+    assert(treeFolder.getNamesWithPrefix("").empty());
+    assert(treeFolder.getSize() == 0);
+
+    // the Folder API behaves the same on both backends
+    for (Folder* target : { &treeFolder, &vectorFolder }) {
+        std::vector<File> treeBatch;
+        for (int i = 0; i < 1000; ++i) { treeBatch.emplace_back("t" + std::to_string(i), "ab"); }
+        assert(target->addFiles(treeBatch) == 1000);
+        assert(target->getSize() == 2000);
+        assert(target->getNamesWithPrefix("t99").size() == 11);
+        assert(target->getNamesInRange("t10", "t11").size() == 11);
+        assert(target->getNamesWithExtension("txt").size() == 1000);
+        assert(target->getFile("t500.txt")->getContents() == "ab");
+    }
+    assert(treeFolder.moveFileTo("t5.txt", docs));
+    assert(!treeFolder.moveFileTo("t5.txt", docs));
+    assert(docs.copyFileTo("t5.txt", treeFolder));
+    assert(treeFolder.getFile("t5.txt") != nullptr);
+    Folder treeCopy(treeFolder); //deep copy
+    assert(treeCopy.removeFile("t5.txt"));
+    assert(treeFolder.getFile("t5.txt") != nullptr);
+    assert(treeCopy.getNamesWithPrefix("").size() == 999);
+    treeFolder.enableContentIndex();
+    assert(treeFolder.searchContents("ab").size() == 1000);
+
+    std::cout << "===========< IMPORT TESTING >===========" << std::endl;
+    fs::path importRoot = fs::temp_directory_path() / "MyTestsImport";
+    fs::remove_all(importRoot);
+    fs::create_directories(importRoot / "sub" / "sub");
+    fs::create_directories(importRoot / "bad-dir");
+    std::ofstream(importRoot / "b.txt") << "hello";
+    std::ofstream(importRoot / "a.log") << "world!";
+    std::ofstream(importRoot / "bad.name.txt") << "skipped";
+    std::ofstream(importRoot / "sub" / "c") << "abc";
+    std::ofstream(importRoot / "bad-dir" / "d.txt") << "skipped";
+    std::ofstream(importRoot / "sub" / "sub" / "e.txt") << "e";
+
+    Importer importer(4);
+    std::vector<Folder> imported = importer.importDirectory(importRoot.string());
+    ImportStats stats = importer.getStats();
+    assert(imported.size() == 3);
+    assert(imported[0].getName() == "MyTestsImport");
+    assert(imported[0].getSize() == 11);
+    assert(imported[1].getName() == "sub");
+    assert(imported[1].getSize() == 3);
+    assert(imported[2].getName() == "sub2"); //sub/sub would clash with sub
+    assert(imported[2].getSize() == 1);
+    assert(stats.files_imported == 4);
+    assert(stats.files_skipped == 1);
+    assert(stats.folders_skipped == 1);
+    assert(stats.folders_renamed == 1);
+    assert(stats.bytes_read == 15);
+    imported[0].display();
+    imported[1].display();
+    std::cout << stats.filesPerSecond() << " files/s, " << stats.megabytesPerSecond() << " MB/s" << std::endl;
+
+    // relative roots are named after the directory they resolve to
+    fs::path startDir = fs::current_path();
+    fs::current_path(importRoot / "sub");
+    std::vector<Folder> dotImport = Importer(1, false).importDirectory(".");
+    assert(dotImport.size() == 1);
+    assert(dotImport[0].getName() == "sub");
+    assert(dotImport[0].getSize() == 3);
+    fs::current_path(importRoot / "sub" / "sub");
+    assert(Importer(1, false).importDirectory("..")[0].getName() == "sub");
+    fs::current_path(startDir);
+    fs::remove_all(importRoot);
 }
\ No newline at end of file